@@ -5,9 +5,132 @@
  * @mail    m.piwowar2@gmail.com
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Instrumentation.h"
 #include "MsgReader.h"
+#include "ReplayDriver.h"
+#include "Validator.h"
+
+/// @comment Without arguments whole file is read before building Order Book, "--input FILE" replaces default input file
+///          of single-file modes, "--stream" and "--threaded" run pipeline, "--binary" writes binary records
+///          instead of CSV, "--depth N" writes N levels per side, "--instruments N [--workers W]" runs synthetic
+///          replay of N instruments on W threads, "--checkpoint-every N" and "--checkpoint-on-clear" write
+///          snapshots of Order Book, "--resume" starts from the latest snapshot, "--check-resume" compares resumed
+///          output with uninterrupted one. Other arguments are input files or directories with *.raw files - they are
+///          processed at once on "--jobs N" threads and written to "--output-dir DIR". "--check-decoder" compares
+///          SIMD decoders with readBinaryFile, "--check-price-moves" runs scripted scenario of modifies.
+///          "--max-orders N" and "--max-levels N" set capacity of each side of every book allocated before the first
+///          tick. "--changed-only" writes only ticks which changed top of book, "--conflate T" writes them at most
+///          once per T of SourceTime (microseconds) per side, "--check-conflation" runs scripted sequence of
+///          conflation. "--view-stress R" checks published top of book (BookView) with R reader threads. "--validate"
+///          replays input file through ReferenceBook, compares CSV output with "--golden FILE" and runs "--fuzz N"
+///          random actions from "--seed S". "--feed ADDRESS" receives records from live feed (unix:PATH,
+///          udp:ADDRESS:PORT, fifo:PATH or - for stdin)
+int main(int argc, char* argv[]) {
+    bool stream = false;
+    std::size_t instruments = 0;
+    std::size_t workers = std::max(1U, std::thread::hardware_concurrency());
+    quant::ReaderOptions options;
+    std::vector<std::string> inputs;
+    std::string outputDir = "result_files";
+    std::size_t jobs = workers;
+    bool checkDecoder = false;
+    bool checkPriceMoves = false;
+    bool checkConflation = false;
+    bool checkResume = false;
+    std::size_t viewReaders = 0;
+    bool validate = false;
+    std::string goldenFile = GOLDEN_FILE;
+    std::size_t fuzzActions = 0;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--stream") == 0) stream = true;
+        else if (std::strcmp(argv[i], "--threaded") == 0) stream = options.threaded = true;
+        else if (std::strcmp(argv[i], "--input") == 0 && i + 1 < argc) options.inputFile = argv[++i];
+        else if (std::strcmp(argv[i], "--binary") == 0) options.format = quant::OutputFormat::binary;
+        else if (std::strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            options.depth = std::clamp<std::size_t>(std::strtoul(argv[++i], nullptr, 10), 1, quant::MAX_DEPTH);
+        }
+        else if (std::strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+            options.checkpointEvery = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--checkpoint-on-clear") == 0) options.checkpointOnClear = true;
+        else if (std::strcmp(argv[i], "--resume") == 0) options.resume = true;
+        else if (std::strcmp(argv[i], "--instruments") == 0 && i + 1 < argc) {
+            instruments = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = std::max<std::size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        }
+        else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = std::max<std::size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        }
+        else if (std::strcmp(argv[i], "--output-dir") == 0 && i + 1 < argc) outputDir = argv[++i];
+        else if (std::strcmp(argv[i], "--check-decoder") == 0) checkDecoder = true;
+        else if (std::strcmp(argv[i], "--check-price-moves") == 0) checkPriceMoves = true;
+        else if (std::strcmp(argv[i], "--check-conflation") == 0) checkConflation = true;
+        else if (std::strcmp(argv[i], "--check-resume") == 0) checkResume = true;
+        else if (std::strcmp(argv[i], "--view-stress") == 0 && i + 1 < argc) {
+            viewReaders = std::max<std::size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        }
+        else if (std::strcmp(argv[i], "--feed") == 0 && i + 1 < argc) options.feed = argv[++i];
+        else if (std::strcmp(argv[i], "--validate") == 0) validate = true;
+        else if (std::strcmp(argv[i], "--golden") == 0 && i + 1 < argc) goldenFile = argv[++i];
+        else if (std::strcmp(argv[i], "--fuzz") == 0 && i + 1 < argc) {
+            fuzzActions = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--changed-only") == 0) options.filter = quant::OutputFilter::changed;
+        else if (std::strcmp(argv[i], "--conflate") == 0 && i + 1 < argc) {
+            options.filter = quant::OutputFilter::conflated;
+            options.conflateInterval = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--max-orders") == 0 && i + 1 < argc) {
+            options.capacity.orders = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--max-levels") == 0 && i + 1 < argc) {
+            options.capacity.levels = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strncmp(argv[i], "--", 2) != 0) inputs.emplace_back(argv[i]);
+    }
 
-int main() {
-    quant::MsgReader::read();
+    try {
+        if (checkDecoder) return quant::MsgReader::checkDecoders(options) ? 0 : 1;
+        if (checkPriceMoves) return quant::MsgReader::checkPriceMoves() ? 0 : 1;
+        if (checkConflation) return quant::MsgReader::checkConflation() ? 0 : 1;
+        if (checkResume) return quant::MsgReader::checkResume(options) ? 0 : 1;
+        if (viewReaders > 0) return quant::MsgReader::stressView(options, viewReaders) ? 0 : 1;
+        if (validate) {
+            if (!inputs.empty()) options.inputFile = inputs.front();
+            return quant::validate(options, goldenFile, fuzzActions, seed) ? 0 : 1;
+        }
+        if (!inputs.empty()) {
+            quant::ReplayDriver driver(outputDir, options, stream);
+            auto start = std::chrono::steady_clock::now();
+            auto reports = driver.run(quant::ReplayDriver::collectInputs(inputs), jobs);
+            quant::ReplayDriver::report(std::cout, reports, std::chrono::steady_clock::now() - start);
+        }
+        else if (instruments > 0) quant::MsgReader::replayInstruments(options, instruments, workers);
+        else if (!options.feed.empty()) quant::MsgReader::live(options);
+        else if (stream) quant::MsgReader::stream(options);
+        else quant::MsgReader::read(options);
+#ifdef ORDER_BOOK_INSTRUMENTATION
+        quant::instrumentation::report(std::cout);
+#endif
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,66 @@
+/**
+ * @file    BenchData.cpp
+ * @brief   Input data shared by benchmarks
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <random>
+
+#include "BenchData.h"
+#include "MsgReader.h"
+#include "TickFile.h"
+
+namespace bench {
+    /// @brief Seed of all synthetic workloads - results are comparable between runs
+    constexpr uint32_t SEED = 20220620;
+
+    const std::vector<quant::Pattern>& decodedTicks() {
+        static const std::vector<quant::Pattern> ticks = [] {
+            quant::TickFile file(INPUT_FILE);
+            return std::vector<quant::Pattern>(file.begin(), file.end());
+        }();
+        return ticks;
+    }
+
+    const std::vector<quant::Pattern>& resultTicks() {
+        static const std::vector<quant::Pattern> ticks = [] {
+            std::vector<quant::Pattern> result = decodedTicks();
+            quant::Book book;
+            for (quant::Pattern& tick : result) {
+                quant::runActions(book, tick);
+            }
+            return result;
+        }();
+        return ticks;
+    }
+
+    std::vector<SyntheticOrder> deepSingleLevel(std::size_t orders) {
+        std::mt19937 random(SEED);
+        std::uniform_int_distribution<uint32_t> qty(1, 100);
+        std::vector<SyntheticOrder> result(orders);
+        for (std::size_t i = 0; i < orders; ++i) result[i] = SyntheticOrder{i + 1, 1000, qty(random)};
+        return result;
+    }
+
+    std::vector<SyntheticOrder> wideSparseBook(std::size_t orders) {
+        std::mt19937 random(SEED);
+        std::uniform_int_distribution<uint32_t> qty(1, 100);
+        std::vector<uint32_t> prices(orders);
+        for (std::size_t i = 0; i < orders; ++i) prices[i] = static_cast<uint32_t>(1000 + 7 * i);
+        std::shuffle(prices.begin(), prices.end(), random);
+        std::vector<SyntheticOrder> result(orders);
+        for (std::size_t i = 0; i < orders; ++i) result[i] = SyntheticOrder{i + 1, prices[i], qty(random)};
+        return result;
+    }
+
+    std::vector<SyntheticOrder> nearTouch(std::size_t orders) {
+        std::mt19937 random(SEED);
+        std::uniform_int_distribution<uint32_t> qty(1, 100);
+        std::geometric_distribution<uint32_t> distance(0.3);
+        std::vector<SyntheticOrder> result(orders);
+        for (std::size_t i = 0; i < orders; ++i) result[i] = SyntheticOrder{i + 1, 1000 - distance(random), qty(random)};
+        return result;
+    }
+} // bench
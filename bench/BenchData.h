@@ -0,0 +1,51 @@
+#ifndef ORDER_BOOK_BENCHDATA_H
+#define ORDER_BOOK_BENCHDATA_H
+
+/**
+ * @file    BenchData.h
+ * @brief   Input data shared by benchmarks - real ticks from input file and synthetic Order Book workloads
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Pattern.h"
+
+/// @namespace "bench" for data and helpers of benchmarks
+namespace bench {
+    /// @brief Ticks of INPUT_FILE decoded once, without result columns
+    const std::vector<quant::Pattern>& decodedTicks();
+
+    /// @brief Ticks of INPUT_FILE with B0..AN0 filled by Order Book
+    const std::vector<quant::Pattern>& resultTicks();
+
+    /// @struct Synthetic Order for benchmarks of single Order Book
+    struct SyntheticOrder {
+        uint64_t orderID;
+        uint32_t price;
+        uint32_t qty;
+    };
+
+    /**
+     * @brief All Orders on the same price - long FIFO queue of one level
+     * @param orders Number of Orders
+     */
+    std::vector<SyntheticOrder> deepSingleLevel(std::size_t orders);
+
+    /**
+     * @brief One Order per price, prices spread randomly over wide range - many levels far from the best one
+     * @param orders Number of Orders (and levels)
+     */
+    std::vector<SyntheticOrder> wideSparseBook(std::size_t orders);
+
+    /**
+     * @brief Orders on few prices around the best one like in real feed - used for add/cancel churn
+     * @param orders Number of Orders
+     */
+    std::vector<SyntheticOrder> nearTouch(std::size_t orders);
+} // bench
+
+#endif //ORDER_BOOK_BENCHDATA_H
@@ -0,0 +1,51 @@
+/**
+ * @file    BookViewBench.cpp
+ * @brief   Cost of publishing top of book to BookView and of reading it by many threads at once
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+#include "BenchData.h"
+#include "BookView.h"
+#include "MsgReader.h"
+
+namespace {
+    /// @comment Book is built once from whole input file - argument is depth of view
+    void viewPublish(benchmark::State& state) {
+        static const quant::Book book = [] {
+            quant::Book result;
+            for (quant::Pattern tick : bench::decodedTicks()) quant::runActions(result, tick);
+            return result;
+        }();
+        quant::BookView view(static_cast<std::size_t>(state.range(0)));
+        quant::Pattern tick{};
+        for (auto _ : state) {
+            view.publish(book, tick);
+            ++tick.SourceTime;
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    /// @comment Thread 0 publishes all the time, other threads read - failed attempts are reported as retries
+    void viewContended(benchmark::State& state) {
+        static quant::BookView view(5);
+        quant::BookSnapshot snapshot;
+        uint64_t retries = 0;
+        for (auto _ : state) {
+            if (state.thread_index() == 0) {
+                snapshot.ticks++;
+                view.publish(snapshot);
+            }
+            else if (!view.tryRead(snapshot)) ++retries;
+            benchmark::DoNotOptimize(snapshot);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        if (state.thread_index() != 0) state.counters["retries"] = benchmark::Counter(static_cast<double>(retries));
+    }
+} // namespace
+
+BENCHMARK(viewPublish)->Arg(1)->Arg(5)->Arg(10);
+BENCHMARK(viewContended)->Threads(2)->Threads(4);
@@ -0,0 +1,48 @@
+/**
+ * @file    CsvWriterBench.cpp
+ * @brief   Benchmark of writing result CSV file - CsvWriter against std::string based printCSV
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <vector>
+
+#include "BenchData.h"
+#include "CsvWriter.h"
+#include "MsgReader.h"
+
+namespace {
+    void printCsvToStream(benchmark::State& state) {
+        std::vector<quant::Pattern> ticks = bench::resultTicks();
+        std::ofstream csvFile("/dev/null");
+        std::size_t bytes = 0;
+        for (auto _ : state) {
+            for (quant::Pattern& tick : ticks) {
+                std::string row = quant::printCSV(tick);
+                bytes += row.size();
+                csvFile << row;
+            }
+            csvFile.flush();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ticks.size()));
+    }
+
+    void csvWriter(benchmark::State& state) {
+        const std::vector<quant::Pattern>& ticks = bench::resultTicks();
+        quant::CsvWriter csvFile("/dev/null");
+        for (auto _ : state) {
+            for (const quant::Pattern& tick : ticks) {
+                csvFile.write(tick);
+            }
+            csvFile.flush();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(csvFile.bytesWritten()));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ticks.size()));
+    }
+} // namespace
+
+BENCHMARK(printCsvToStream)->Unit(benchmark::kMillisecond);
+BENCHMARK(csvWriter)->Unit(benchmark::kMillisecond);
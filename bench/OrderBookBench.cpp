@@ -0,0 +1,133 @@
+/**
+ * @file    OrderBookBench.cpp
+ * @brief   Microbenchmarks of single Order Book operations on synthetic workloads
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "BenchData.h"
+#include "OrderBook.h"
+
+namespace {
+    using Workload = std::vector<bench::SyntheticOrder> (*)(std::size_t);
+
+    /// @comment Books are filled before timing, so only the measured operation is counted
+    void fill(quant::OrderBook<quant::Side::bid>& orderBook, const std::vector<bench::SyntheticOrder>& orders) {
+        for (const bench::SyntheticOrder& order : orders) orderBook.addOrder(order.orderID, order.price, order.qty);
+    }
+
+    template<Workload workload>
+    void addOrder(benchmark::State& state) {
+        const std::vector<bench::SyntheticOrder> orders = workload(static_cast<std::size_t>(state.range(0)));
+        quant::OrderBook<quant::Side::bid> orderBook;
+        for (auto _ : state) {
+            fill(orderBook, orders);
+            state.PauseTiming();
+            orderBook.clearAll();
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * orders.size()));
+    }
+
+    template<Workload workload>
+    void popOrder(benchmark::State& state) {
+        const std::vector<bench::SyntheticOrder> orders = workload(static_cast<std::size_t>(state.range(0)));
+        quant::OrderBook<quant::Side::bid> orderBook;
+        for (auto _ : state) {
+            state.PauseTiming();
+            fill(orderBook, orders);
+            state.ResumeTiming();
+            for (const bench::SyntheticOrder& order : orders) orderBook.popOrder(order.orderID);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * orders.size()));
+    }
+
+    /// @comment Steady state book - every step cancels the oldest Order and adds a new one in its place
+    template<Workload workload>
+    void cancelChurn(benchmark::State& state) {
+        const std::size_t resting = static_cast<std::size_t>(state.range(0));
+        const std::vector<bench::SyntheticOrder> orders = workload(resting * 4);
+        quant::OrderBook<quant::Side::bid> orderBook;
+        std::vector<uint64_t> live(resting);
+        for (std::size_t i = 0; i < resting; ++i) {
+            live[i] = orders[i].orderID;
+            orderBook.addOrder(orders[i].orderID, orders[i].price, orders[i].qty);
+        }
+        uint64_t nextID = orders.size() + 1;
+        std::size_t step = 0;
+        for (auto _ : state) {
+            const bench::SyntheticOrder& next = orders[(step + resting) % orders.size()];
+            uint64_t& oldest = live[step++ % resting];
+            orderBook.popOrder(oldest);
+            oldest = nextID++;
+            orderBook.addOrder(oldest, next.price, next.qty);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2));
+    }
+
+    void modifyQty(benchmark::State& state) {
+        const std::vector<bench::SyntheticOrder> orders = bench::nearTouch(static_cast<std::size_t>(state.range(0)));
+        quant::OrderBook<quant::Side::bid> orderBook;
+        fill(orderBook, orders);
+        std::size_t i = 0;
+        for (auto _ : state) {
+            const bench::SyntheticOrder& order = orders[i++ % orders.size()];
+            benchmark::DoNotOptimize(orderBook.modifyOrder(order.orderID, order.price, order.qty + (i & 7)));
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    template<Workload workload>
+    void bestPrice(benchmark::State& state) {
+        quant::OrderBook<quant::Side::bid> orderBook;
+        fill(orderBook, workload(static_cast<std::size_t>(state.range(0))));
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(orderBook.bestPrice());
+            benchmark::DoNotOptimize(orderBook.getBestShares());
+        }
+    }
+
+    template<Workload workload>
+    void noShares(benchmark::State& state) {
+        const std::vector<bench::SyntheticOrder> orders = workload(static_cast<std::size_t>(state.range(0)));
+        quant::OrderBook<quant::Side::bid> orderBook;
+        fill(orderBook, orders);
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(orderBook.noShares(orders[i++ % orders.size()].price));
+        }
+    }
+
+    /// @comment Clear is O(1), so iterations are fixed - otherwise untimed refills would run for minutes
+    template<Workload workload>
+    void clearAll(benchmark::State& state) {
+        const std::vector<bench::SyntheticOrder> orders = workload(static_cast<std::size_t>(state.range(0)));
+        quant::OrderBook<quant::Side::bid> orderBook;
+        for (auto _ : state) {
+            state.PauseTiming();
+            fill(orderBook, orders);
+            state.ResumeTiming();
+            orderBook.clearAll();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * orders.size()));
+    }
+} // namespace
+
+BENCHMARK_TEMPLATE(addOrder, bench::deepSingleLevel)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(addOrder, bench::wideSparseBook)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(addOrder, bench::nearTouch)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(popOrder, bench::deepSingleLevel)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(popOrder, bench::wideSparseBook)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(popOrder, bench::nearTouch)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(cancelChurn, bench::deepSingleLevel)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(cancelChurn, bench::wideSparseBook)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(cancelChurn, bench::nearTouch)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK(modifyQty)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(bestPrice, bench::wideSparseBook)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(noShares, bench::deepSingleLevel)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(noShares, bench::wideSparseBook)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(clearAll, bench::deepSingleLevel)->RangeMultiplier(8)->Range(64, 32768)->Iterations(1000);
+BENCHMARK_TEMPLATE(clearAll, bench::wideSparseBook)->RangeMultiplier(8)->Range(64, 32768)->Iterations(1000);
@@ -0,0 +1,96 @@
+/**
+ * @file    OrderIndexBench.cpp
+ * @brief   Order ID index alone on operations of input file - std::unordered_map against OrderIndex
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "BenchData.h"
+#include "OrderIndex.h"
+
+namespace {
+    /// @struct Index operation of one tick - the same lookups Order Book does for its Action
+    struct IdOperation {
+        uint8_t action;
+        uint64_t orderID;
+    };
+
+    const std::vector<IdOperation>& idOperations() {
+        static const std::vector<IdOperation> operations = [] {
+            std::vector<IdOperation> result;
+            for (const quant::Pattern& tick : bench::decodedTicks()) result.push_back({tick.Action, tick.OrderId});
+            return result;
+        }();
+        return operations;
+    }
+
+    /// @comment IDs are date followed by 6 digits of sequence - direct range covers sequences of the busiest day
+    std::pair<uint64_t, std::size_t> busiestDay() {
+        std::unordered_map<uint64_t, std::size_t> days;
+        for (const IdOperation& operation : idOperations()) ++days[operation.orderID / 1000000];
+        auto day = std::max_element(days.begin(), days.end(),
+                                    [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+        return {day->first * 1000000, 1000000};
+    }
+
+    /// @comment Handles are fake (position of tick) - only cost of index is measured
+    template<typename Index, typename Emplace, typename Find, typename Erase>
+    void replay(benchmark::State& state, Index& index, Emplace emplace, Find find, Erase erase) {
+        const std::vector<IdOperation>& operations = idOperations();
+        for (auto _ : state) {
+            quant::OrderHandle handle = 0;
+            for (const IdOperation& operation : operations) {
+                switch (operation.action) {
+                    case quant::Action::add:
+                        emplace(index, operation.orderID, handle++);
+                        break;
+                    case quant::Action::modify:
+                        if (find(index, operation.orderID) == quant::NO_HANDLE) emplace(index, operation.orderID, handle++);
+                        break;
+                    case quant::Action::remove:
+                        erase(index, operation.orderID);
+                        break;
+                    default:
+                        index.clear();
+                }
+            }
+            index.clear();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * operations.size()));
+    }
+
+    void indexUnorderedMap(benchmark::State& state) {
+        std::unordered_map<uint64_t, quant::OrderHandle> index;
+        replay(state, index,
+               [](auto& map, uint64_t id, quant::OrderHandle handle) { map.try_emplace(id, handle); },
+               [](const auto& map, uint64_t id) {
+                   auto it = map.find(id);
+                   return it == map.end() ? quant::NO_HANDLE : it->second;
+               },
+               [](auto& map, uint64_t id) { map.erase(id); });
+    }
+
+    /// @comment Argument 1 turns direct range on
+    void indexFlat(benchmark::State& state) {
+        quant::OrderIndex index;
+        if (state.range(0)) {
+            auto [base, size] = busiestDay();
+            index.directRange(base, size);
+            state.SetLabel("direct");
+        }
+        replay(state, index,
+               [](auto& flat, uint64_t id, quant::OrderHandle handle) { flat.tryEmplace(id, handle); },
+               [](const auto& flat, uint64_t id) { return flat.find(id); },
+               [](auto& flat, uint64_t id) { flat.erase(id); });
+    }
+} // namespace
+
+BENCHMARK(indexUnorderedMap);
+BENCHMARK(indexFlat)->Arg(0)->Arg(1);
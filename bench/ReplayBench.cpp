@@ -0,0 +1,111 @@
+/**
+ * @file    ReplayBench.cpp
+ * @brief   End-to-end replay of input file split into phases - decode, build Order Book and write result
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "BatchDecoder.h"
+#include "BenchData.h"
+#include "BinaryWriter.h"
+#include "CsvWriter.h"
+#include "MsgReader.h"
+#include "TickFile.h"
+
+namespace {
+    void replayDecode(benchmark::State& state) {
+        quant::TickFile file(INPUT_FILE);
+        std::vector<quant::Pattern> ticks(file.size());
+        for (auto _ : state) {
+            std::size_t i = 0;
+            for (const quant::Pattern& tick : file) ticks[i++] = tick;
+            benchmark::DoNotOptimize(ticks.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file.size() * quant::RECORD_SIZE));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * file.size()));
+    }
+
+    /// @comment Blocks of the same size as streaming pipeline, argument is DecoderKind
+    void replayDecodeColumns(benchmark::State& state) {
+        const auto kind = static_cast<quant::DecoderKind>(state.range(0));
+        if (!quant::decoderSupported(kind)) {
+            state.SkipWithError("decoder not supported by CPU");
+            return;
+        }
+        state.SetLabel(quant::decoderName(kind));
+        quant::TickFile file(INPUT_FILE);
+        quant::TickColumns columns;
+        columns.resize(quant::TickBatch::CAPACITY);
+        for (auto _ : state) {
+            for (std::size_t first = 0; first < file.size(); first += quant::TickBatch::CAPACITY) {
+                std::size_t size = std::min(quant::TickBatch::CAPACITY, file.size() - first);
+                quant::decodeColumns(kind, file.at(first).data(), size, columns);
+                benchmark::DoNotOptimize(columns.Qty.data());
+            }
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file.size() * quant::RECORD_SIZE));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * file.size()));
+    }
+
+    /// @comment Argument is depth of result - 1 means only best levels taken by @fn processTick
+    void replayBuild(benchmark::State& state) {
+        const std::size_t depth = static_cast<std::size_t>(state.range(0));
+        const std::vector<quant::Pattern>& decoded = bench::decodedTicks();
+        std::vector<quant::Pattern> ticks;
+        std::vector<quant::Quote> levels(2 * (depth - 1));
+        for (auto _ : state) {
+            state.PauseTiming();
+            ticks = decoded;
+            state.ResumeTiming();
+            quant::Book book;
+            for (quant::Pattern& tick : ticks) {
+                quant::runActions(book, tick);
+                quant::processDepth(book, depth, levels.data());
+            }
+            benchmark::DoNotOptimize(levels.data());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * decoded.size()));
+    }
+
+    template<typename fileWriter>
+    void replayWrite(benchmark::State& state) {
+        const std::vector<quant::Pattern>& ticks = bench::resultTicks();
+        fileWriter writer("/dev/null");
+        writer.writeHeader();
+        for (auto _ : state) {
+            for (const quant::Pattern& tick : ticks) writer.write(tick);
+            writer.flush();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ticks.size()));
+    }
+
+    void replayEndToEnd(benchmark::State& state) {
+        quant::TickFile file(INPUT_FILE);
+        quant::CsvWriter writer("/dev/null");
+        for (auto _ : state) {
+            quant::Book book;
+            writer.writeHeader();
+            for (quant::Pattern tick : file) {
+                quant::runActions(book, tick);
+                writer.write(tick);
+            }
+            writer.flush();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * file.size()));
+    }
+} // namespace
+
+BENCHMARK(replayDecode)->Unit(benchmark::kMillisecond);
+BENCHMARK(replayDecodeColumns)
+    ->Arg(static_cast<int64_t>(quant::DecoderKind::scalar))
+    ->Arg(static_cast<int64_t>(quant::DecoderKind::ssse3))
+    ->Arg(static_cast<int64_t>(quant::DecoderKind::avx2))
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(replayBuild)->Arg(1)->Arg(5)->Arg(quant::MAX_DEPTH)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(replayWrite, quant::CsvWriter)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(replayWrite, quant::BinaryWriter)->Unit(benchmark::kMillisecond);
+BENCHMARK(replayEndToEnd)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,84 @@
+#ifndef ORDER_BOOK_BATCHDECODER_H
+#define ORDER_BOOK_BATCHDECODER_H
+
+/**
+ * @file    BatchDecoder.h
+ * @brief   Decoding blocks of big-endian input records into structure of arrays with SIMD byte swaps
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @struct Decoded records as structure of arrays - one column per field of input record
+    struct TickColumns {
+        std::vector<uint64_t> SourceTime;
+        std::vector<uint8_t> Side;
+        std::vector<uint8_t> Action;
+        std::vector<uint64_t> OrderId;
+        std::vector<uint32_t> Price;
+        std::vector<uint32_t> Qty;
+
+        /// @brief Make place for given number of records in every column
+        void resize(std::size_t size) {
+            SourceTime.resize(size);
+            Side.resize(size);
+            Action.resize(size);
+            OrderId.resize(size);
+            Price.resize(size);
+            Qty.resize(size);
+        }
+
+        /// @brief Returning number of records
+        std::size_t size() const { return SourceTime.size(); }
+
+        /**
+         * @brief Tick made of one row - result columns are not set (UINT32_MAX)
+         * @param index Number of record
+         */
+        Pattern tick(std::size_t index) const {
+            Pattern tick;
+            tick.SourceTime = SourceTime[index];
+            tick.Side = Side[index];
+            tick.Action = Action[index];
+            tick.OrderId = OrderId[index];
+            tick.Price = Price[index];
+            tick.Qty = Qty[index];
+            return tick;
+        }
+    };
+
+    /// @enum Implementations of decoder - the best one supported by CPU is chosen at runtime
+    enum class DecoderKind : uint8_t { scalar, ssse3, avx2 };
+
+    /// @brief Name of implementation for reports
+    const char* decoderName(DecoderKind kind);
+
+    /// @brief Checking if CPU can run given implementation (CPUID)
+    bool decoderSupported(DecoderKind kind);
+
+    /// @brief The best implementation supported by CPU, chosen once
+    DecoderKind activeDecoder();
+
+    /**
+     * @brief Decode packed big-endian records into columns with the best implementation supported by CPU
+     * @param records Pointer to the first byte of the first record (no alignment is required)
+     * @param count Number of records
+     * @param columns Columns with at least count rows, rows 0..count-1 are overwritten
+     */
+    void decodeColumns(const unsigned char* records, std::size_t count, TickColumns& columns);
+
+    /**
+     * @brief Same as @fn decodeColumns with given implementation - used to compare implementations
+     * @param kind Implementation, has to be supported by CPU
+     */
+    void decodeColumns(DecoderKind kind, const unsigned char* records, std::size_t count, TickColumns& columns);
+} // quant
+
+#endif //ORDER_BOOK_BATCHDECODER_H
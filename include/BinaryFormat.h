@@ -0,0 +1,143 @@
+#ifndef ORDER_BOOK_BINARYFORMAT_H
+#define ORDER_BOOK_BINARYFORMAT_H
+
+/**
+ * @file    BinaryFormat.h
+ * @brief   Compact binary result file - fixed-width little-endian records which can be read straight from mmap
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <endian.h>
+#include <string>
+
+#include "MappedFile.h"
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Magic number at the beginning of binary result file - "QOBR" as read from file
+    constexpr uint32_t BINARY_MAGIC = 0x52424F51;
+    /// @brief Version of layout of BinaryHeader and BinaryRecord
+    constexpr uint16_t BINARY_VERSION = 1;
+
+    /// @enum Bits of BinaryRecord::present - set bit means that value exists (instead of UINT32_MAX in Pattern)
+    enum Presence : uint8_t {
+        hasB0 = 1 << 0, hasBQ0 = 1 << 1, hasBN0 = 1 << 2, hasA0 = 1 << 3, hasAQ0 = 1 << 4, hasAN0 = 1 << 5
+    };
+
+    /// @struct Header of binary result file, all fields are little-endian.
+    ///         recordSize = sizeof(BinaryRecord) + 2 * (depth - 1) * sizeof(BinaryQuote)
+    struct BinaryHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordSize;
+        uint64_t count;
+    };
+
+    /// @struct One tick in binary result file, all fields are little-endian, missing values are 0
+    struct BinaryRecord {
+        uint64_t SourceTime;
+        uint64_t OrderId;
+        uint32_t Price;
+        uint32_t Qty;
+        uint32_t B0;
+        uint32_t BQ0;
+        uint32_t BN0;
+        uint32_t A0;
+        uint32_t AQ0;
+        uint32_t AN0;
+        uint8_t Side;
+        uint8_t Action;
+        uint8_t present;
+        uint8_t reserved[5];
+    };
+
+    /// @struct Deeper level following BinaryRecord - bid levels 1..depth-1 and then ask levels 1..depth-1.
+    ///         Level which doesn't exist is stored as zeros (existing level has always Orders > 0)
+    struct BinaryQuote {
+        uint32_t Price;
+        uint32_t Qty;
+        uint32_t Orders;
+    };
+
+    static_assert(sizeof(BinaryHeader) == 16, "BinaryHeader layout is part of file format");
+    static_assert(sizeof(BinaryRecord) == 56, "BinaryRecord layout is part of file format");
+    static_assert(sizeof(BinaryQuote) == 12, "BinaryQuote layout is part of file format");
+
+    /**
+     * @brief Size of one record in file with given depth - it keeps records aligned to 8 bytes
+     * @param depth Number of levels per side
+     */
+    constexpr std::size_t binaryRecordSize(std::size_t depth) {
+        return sizeof(BinaryRecord) + 2 * (depth - 1) * sizeof(BinaryQuote);
+    }
+
+    /**
+     * @brief Convert tick to binary record
+     * @param tick Struct with data per tick
+     * @param record Record to fill
+     */
+    void encodeRecord(const Pattern& tick, BinaryRecord& record);
+
+    /**
+     * @brief Convert binary record back to tick - missing values are set to UINT32_MAX again
+     * @param record Record read from file
+     * @param tick Struct to store data per tick
+     */
+    void decodeRecord(const BinaryRecord& record, Pattern& tick);
+
+    /**
+     * @brief Convert level to binary form
+     * @param quote Level of Order Book
+     * @param binary Level to fill
+     */
+    void encodeQuote(const Quote& quote, BinaryQuote& binary);
+
+    /**
+     * @brief Convert binary level back - missing level gets UINT32_MAX again
+     * @param binary Level read from file
+     * @param quote Level to fill
+     */
+    void decodeQuote(const BinaryQuote& binary, Quote& quote);
+
+    /// @brief Read-only mapping of binary result file
+    class BinaryFile {
+    public:
+        /**
+         * @brief Map file and check its header, throws std::runtime_error if file isn't binary result file
+         * @param path Path to binary result file
+         */
+        explicit BinaryFile(const std::string& path);
+
+        /// @brief Returning number of records
+        std::size_t size() const { return _size; }
+
+        /// @brief Returning number of levels per side stored in each record
+        std::size_t depth() const { return _depth; }
+
+        /// @brief Access to record with given index - fields are little-endian
+        const BinaryRecord& operator[](std::size_t index) const {
+            return *reinterpret_cast<const BinaryRecord*>(_records + index * binaryRecordSize(_depth));
+        }
+
+        /// @brief Deeper levels of record with given index - 2 * (depth - 1) elements
+        const BinaryQuote* quotes(std::size_t index) const {
+            return reinterpret_cast<const BinaryQuote*>(_records + index * binaryRecordSize(_depth) + sizeof(BinaryRecord));
+        }
+
+    private:
+        /// @brief Mapping of whole file
+        MappedFile _file;
+        /// @brief First record inside mapping
+        const unsigned char* _records = nullptr;
+        /// @brief Number of records
+        std::size_t _size = 0;
+        /// @brief Number of levels per side
+        std::size_t _depth = 1;
+    };
+} // quant
+
+#endif //ORDER_BOOK_BINARYFORMAT_H
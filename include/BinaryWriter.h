@@ -0,0 +1,87 @@
+#ifndef ORDER_BOOK_BINARYWRITER_H
+#define ORDER_BOOK_BINARYWRITER_H
+
+/**
+ * @file    BinaryWriter.h
+ * @brief   Writer of compact binary result file - alternative to CsvWriter with the same interface
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "BinaryFormat.h"
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Writer of BinaryRecord per tick, header is kept up to date on each flush
+    class BinaryWriter {
+    public:
+        /// @brief Size of output buffer - one write call per this number of bytes
+        static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+        /**
+         * @brief Create or truncate (unless kept) output file, throws std::system_error if file can't be open
+         * @param path Path to output binary file
+         * @param keep Keep content of existing file for @fn continueAfter
+         */
+        explicit BinaryWriter(const std::string& path, bool keep = false);
+        BinaryWriter(const BinaryWriter&) = delete;
+        BinaryWriter& operator=(const BinaryWriter&) = delete;
+        ~BinaryWriter();
+
+        /**
+         * @brief Write BinaryHeader with number of records equal 0
+         * @param depth Number of levels per side - defines size of each record
+         */
+        void writeHeader(std::size_t depth = 1);
+
+        /**
+         * @brief Used instead of writeHeader when processing is resumed from snapshot - given number of records of
+         *        existing file are kept, records after them are removed and next records follow them.
+         *        Throws std::runtime_error if file has other header or fewer records
+         * @param rows Number of records to keep
+         * @param depth Number of levels per side - size of records in header has to match it
+         */
+        void continueAfter(std::size_t rows, std::size_t depth = 1);
+
+        /**
+         * @brief Convert tick to BinaryRecord followed by BinaryQuote of deeper levels in buffer
+         * @param tick Struct with data per tick
+         * @param levels 2 * (depth - 1) levels: bid levels 1..depth-1 followed by ask levels 1..depth-1
+         * @param depth Number of levels per side, the same as given to writeHeader
+         */
+        void write(const Pattern& tick, const Quote* levels = nullptr, std::size_t depth = 1);
+
+        /// @brief Write buffered records and update number of records in header, throws std::system_error if it fails
+        void flush();
+
+        /// @brief Returning number of bytes written so far (including still buffered ones)
+        std::size_t bytesWritten() const { return sizeof(BinaryHeader) + (_flushed + _used) * _recordSize; }
+
+    private:
+        /**
+         * @brief Write bytes at given offset of file
+         * @param data Bytes to write
+         * @param size Number of bytes
+         * @param offset Position in file
+         */
+        void writeAt(const void* data, std::size_t size, std::size_t offset);
+
+        /// @brief Descriptor of output file
+        int _fd = -1;
+        /// @brief Output buffer - allocated as records to keep them aligned
+        std::unique_ptr<BinaryRecord[]> _buffer;
+        /// @brief Size of one record with deeper levels
+        std::size_t _recordSize = sizeof(BinaryRecord);
+        /// @brief Number of records used in _buffer
+        std::size_t _used = 0;
+        /// @brief Number of records already written to file
+        std::size_t _flushed = 0;
+    };
+} // quant
+
+#endif //ORDER_BOOK_BINARYWRITER_H
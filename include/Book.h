@@ -0,0 +1,53 @@
+#ifndef ORDER_BOOK_BOOK_H
+#define ORDER_BOOK_BOOK_H
+
+/**
+ * @file    Book.h
+ * @brief   Both sides of Order Book of one instrument
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include "OrderBook.h"
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @struct Bid and ask Order Books of one instrument - side is chosen at compile time by @fn of
+    struct Book {
+        /**
+         * @param capacity Orders and price levels allocated up front for each side
+         */
+        explicit Book(const BookCapacity& capacity = BookCapacity{}) : bidOrderBook(capacity), askOrderBook(capacity) {}
+
+        /// @brief Order Book dedicated to bid prices and logic
+        OrderBook<Side::bid> bidOrderBook;
+        /// @brief Order Book dedicated to ask prices and logic
+        OrderBook<Side::ask> askOrderBook;
+        /// @brief Best bid written to the last tick - empty Quote if bid side was empty
+        Quote bidTop;
+        /// @brief Best ask written to the last tick - empty Quote if ask side was empty
+        Quote askTop;
+
+        /// @brief Order Book of given side
+        template<Side side>
+        OrderBook<side>& of() {
+            if constexpr (Side::bid == side) return bidOrderBook;
+            else return askOrderBook;
+        }
+
+        template<Side side>
+        const OrderBook<side>& of() const {
+            if constexpr (Side::bid == side) return bidOrderBook;
+            else return askOrderBook;
+        }
+
+        /// @brief Clear both sides - last written top of book is kept, so next tick reports its change
+        void clearAll() {
+            bidOrderBook.clearAll();
+            askOrderBook.clearAll();
+        }
+    };
+} // quant
+
+#endif //ORDER_BOOK_BOOK_H
@@ -0,0 +1,100 @@
+#ifndef ORDER_BOOK_BOOKMANAGER_H
+#define ORDER_BOOK_BOOKMANAGER_H
+
+/**
+ * @file    BookManager.h
+ * @brief   Many instruments processed by fixed set of worker threads - every worker owns its Order Books
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Book.h"
+#include "Pattern.h"
+#include "TickFile.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @struct Ticks of many instruments passed from router to one worker - records are still encoded, worker
+    ///         decodes them, so router only reads InstrumentId and copies bytes
+    struct InstrumentBatch {
+        static constexpr std::size_t CAPACITY = 1024;
+        std::size_t size = 0;
+        std::array<uint32_t, CAPACITY> instrumentIds;
+        std::array<std::array<unsigned char, RECORD_SIZE>, CAPACITY> records;
+    };
+
+    /**
+     * @brief Router of ticks to worker threads - instrument always goes to the same worker, so its ticks keep order
+     * @comment route and finish have to be called from one thread. Workers don't share anything, so there are
+     *          no locks on hot path - batches are passed through lock-free single-producer/single-consumer queues
+     */
+    class BookManager {
+    public:
+        /// @brief Called on worker thread after each processed tick (tick has B0..AN0 filled)
+        using Listener = std::function<void(std::size_t worker, uint32_t instrumentId, const Pattern& tick)>;
+
+        /// @struct Summary of work done by one worker
+        struct WorkerStats {
+            std::size_t ticks;
+            std::size_t instruments;
+        };
+
+        /**
+         * @brief Start worker threads
+         * @param workers Number of worker threads, at least 1
+         * @param capacity Orders and price levels allocated for each side of every new book
+         * @param listener Optional consumer of results
+         */
+        explicit BookManager(std::size_t workers, const BookCapacity& capacity = BookCapacity{},
+                             Listener listener = nullptr);
+        BookManager(const BookManager&) = delete;
+        BookManager& operator=(const BookManager&) = delete;
+        ~BookManager();
+
+        /**
+         * @brief Pass record to worker owning the instrument, record is buffered until batch is full. Only
+         *        InstrumentId is read here - the rest of record is decoded by worker
+         * @param record Extended record - big-endian InstrumentId followed by standard record
+         */
+        void route(const unsigned char* record);
+
+        /// @brief Send buffered ticks, wait until workers process everything and stop them
+        void finish();
+
+        /**
+         * @brief Returning worker owning instrument
+         * @param instrumentId ID of instrument
+         */
+        std::size_t workerOf(uint32_t instrumentId) const;
+
+        /// @brief Returning statistics of each worker, valid after finish
+        std::vector<WorkerStats> stats() const;
+
+    private:
+        struct Worker;
+
+        /**
+         * @brief Pass filled batch to worker and take free one
+         * @param worker Worker to get the batch
+         */
+        void dispatch(Worker& worker);
+
+        /// @brief Workers with their queues, books and threads
+        std::vector<std::unique_ptr<Worker>> _workers;
+        /// @brief Capacity of books created for new instruments
+        BookCapacity _capacity;
+        /// @brief Consumer of results
+        Listener _listener;
+        /// @brief Flag if workers are already stopped
+        bool _finished = false;
+    };
+} // quant
+
+#endif //ORDER_BOOK_BOOKMANAGER_H
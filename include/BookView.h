@@ -0,0 +1,168 @@
+#ifndef ORDER_BOOK_BOOKVIEW_H
+#define ORDER_BOOK_BOOKVIEW_H
+
+/**
+ * @file    BookView.h
+ * @brief   Top of Order Book published by book thread for any number of reader threads (seqlock)
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "Book.h"
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @struct Bid and ask level at the same distance from the best price
+    struct LevelPair {
+        Quote bid;
+        Quote ask;
+    };
+
+    /// @struct Copy of top of Order Book taken after one tick - levels which don't exist are empty Quotes
+    struct BookSnapshot {
+        /// @brief Number of ticks applied to the book when snapshot was published
+        uint64_t ticks = 0;
+        /// @brief SourceTime of the last applied tick
+        uint64_t sourceTime = 0;
+        /// @brief Number of all price levels of each side, not only published ones
+        uint32_t bidLevels = 0;
+        uint32_t askLevels = 0;
+        /// @brief The best levels, only first depth of BookView are published
+        std::array<LevelPair, MAX_DEPTH> levels;
+    };
+
+    /**
+     * @brief Seqlock over snapshot of the best levels - one writer (book thread), any number of readers
+     * @comment Writer makes version odd, stores snapshot and makes version even again - it never waits for readers.
+     *          Reader copies snapshot between two loads of version and accepts it only if both are the same even
+     *          value, so torn copy is never returned. Snapshot is kept in relaxed atomic words, so concurrent copy
+     *          is not a data race. Only the first depth levels are copied by both sides.
+     */
+    class BookView {
+    public:
+        /**
+         * @param depth Number of levels of each side published (1..MAX_DEPTH) - empty book is published at start
+         */
+        explicit BookView(std::size_t depth = 1)
+            : _depth(std::clamp<std::size_t>(depth, 1, MAX_DEPTH)),
+              _usedWords((offsetof(BookSnapshot, levels) + _depth * sizeof(LevelPair) + sizeof(uint64_t) - 1) /
+                         sizeof(uint64_t)) { publish(BookSnapshot{}); }
+        BookView(const BookView&) = delete;
+        BookView& operator=(const BookView&) = delete;
+
+        /// @brief Returning number of levels of each side published
+        std::size_t depth() const { return _depth; }
+
+        /**
+         * @brief Publish state of book after tick - called only by book thread
+         * @param book Both sides of Order Book after @fn runActions
+         * @param tick The last applied tick
+         */
+        void publish(const Book& book, const Pattern& tick);
+
+        /**
+         * @brief Publish given snapshot - called only by book thread
+         * @param snapshot Snapshot, only first depth levels are published
+         */
+        void publish(const BookSnapshot& snapshot);
+
+        /**
+         * @brief Single attempt of reading, wait-free - never blocks and never retries
+         * @param snapshot Filled with published snapshot, untouched levels beyond depth
+         * @return False if writer was publishing at the same time - snapshot has to be ignored then
+         */
+        bool tryRead(BookSnapshot& snapshot) const;
+
+        /**
+         * @brief Read consistent snapshot, retry while writer is publishing
+         * @param snapshot Filled with published snapshot
+         * @return Number of failed attempts before success
+         */
+        std::size_t read(BookSnapshot& snapshot) const;
+
+    private:
+        /// @brief Number of 8-byte words of whole snapshot
+        static constexpr std::size_t WORDS = (sizeof(BookSnapshot) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        /// @brief Number of levels of each side published
+        std::size_t _depth;
+        /// @brief Number of words of snapshot covering header and depth levels
+        std::size_t _usedWords;
+        /// @brief Snapshot filled by publish(book, tick) - writer only, kept so levels aren't initialized each time
+        BookSnapshot _next;
+        /// @brief Odd while writer is storing snapshot, incremented twice by each publish
+        alignas(64) std::atomic<uint64_t> _version{0};
+        /// @brief Snapshot as words
+        std::array<std::atomic<uint64_t>, WORDS> _words{};
+    };
+
+    static_assert(sizeof(BookSnapshot) % sizeof(uint64_t) == 0, "BookSnapshot has to be made of whole words");
+
+    /// @comment Definitions are in header, so publishing is inlined into replay loop
+
+    inline void BookView::publish(const Book& book, const Pattern& tick) {
+        ++_next.ticks;
+        _next.sourceTime = tick.SourceTime;
+        _next.bidLevels = static_cast<uint32_t>(book.bidOrderBook.noLevels());
+        _next.askLevels = static_cast<uint32_t>(book.askOrderBook.noLevels());
+        for (std::size_t i = 0; i < _depth; ++i) {
+            LevelPair& pair = _next.levels[i];
+            if (i < _next.bidLevels) {
+                const Level& level = book.bidOrderBook.levelAt(i);
+                pair.bid = Quote{level.price, level.shares, level.orders};
+            }
+            else pair.bid = Quote{};
+            if (i < _next.askLevels) {
+                const Level& level = book.askOrderBook.levelAt(i);
+                pair.ask = Quote{level.price, level.shares, level.orders};
+            }
+            else pair.ask = Quote{};
+        }
+        publish(_next);
+    }
+
+    /// @comment Words are taken straight from snapshot - only header and depth levels are copied
+    inline void BookView::publish(const BookSnapshot& snapshot) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&snapshot);
+        const uint64_t version = _version.load(std::memory_order_relaxed);
+        _version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < _usedWords; ++i) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+            _words[i].store(word, std::memory_order_relaxed);
+        }
+        _version.store(version + 2, std::memory_order_release);
+    }
+
+    inline bool BookView::tryRead(BookSnapshot& snapshot) const {
+        uint64_t words[WORDS];
+        const uint64_t before = _version.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        for (std::size_t i = 0; i < _usedWords; ++i) words[i] = _words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_version.load(std::memory_order_relaxed) != before) return false;
+        std::memcpy(&snapshot, words, _usedWords * sizeof(uint64_t));
+        return true;
+    }
+
+    /// @comment Writer is never blocked, so retry succeeds as soon as one publish doesn't overlap with the copy
+    inline std::size_t BookView::read(BookSnapshot& snapshot) const {
+        std::size_t retries = 0;
+        while (!tryRead(snapshot)) {
+            if (++retries % 64 == 0) std::this_thread::yield();
+        }
+        return retries;
+    }
+} // quant
+
+#endif //ORDER_BOOK_BOOKVIEW_H
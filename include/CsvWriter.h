@@ -0,0 +1,77 @@
+#ifndef ORDER_BOOK_CSVWRITER_H
+#define ORDER_BOOK_CSVWRITER_H
+
+/**
+ * @file    CsvWriter.h
+ * @brief   Allocation-free writer of result CSV file - rows are formatted straight into one reusable buffer
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Writer producing exactly same rows as @fn printCSV, flushed to file with large write calls
+    class CsvWriter {
+    public:
+        /// @brief Size of output buffer - one write call per this number of bytes
+        static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+        /**
+         * @brief Create or truncate (unless kept) output file, throws std::system_error if file can't be open
+         * @param path Path to output CSV file
+         * @param keep Keep content of existing file for @fn continueAfter
+         */
+        explicit CsvWriter(const std::string& path, bool keep = false);
+        CsvWriter(const CsvWriter&) = delete;
+        CsvWriter& operator=(const CsvWriter&) = delete;
+        ~CsvWriter();
+
+        /**
+         * @brief Write line with names of columns
+         * @param depth Number of levels per side - columns B1..A(depth-1) are added after AN0
+         */
+        void writeHeader(std::size_t depth = 1);
+
+        /**
+         * @brief Used instead of writeHeader when processing is resumed from snapshot - header and given number of
+         *        rows of existing file are kept, rows after them are removed and next rows follow them.
+         *        Throws std::runtime_error if file has other header or fewer rows
+         * @param rows Number of rows to keep
+         * @param depth Number of levels per side - header of file has to be the same as written by writeHeader
+         */
+        void continueAfter(std::size_t rows, std::size_t depth = 1);
+
+        /**
+         * @brief Format tick as one CSV row into buffer
+         * @param tick Struct with data per tick
+         * @param levels 2 * (depth - 1) levels: bid levels 1..depth-1 followed by ask levels 1..depth-1
+         * @param depth Number of levels per side, not bigger than MAX_DEPTH
+         */
+        void write(const Pattern& tick, const Quote* levels = nullptr, std::size_t depth = 1);
+
+        /// @brief Write whole buffer to file, throws std::system_error if it fails
+        void flush();
+
+        /// @brief Returning number of bytes written so far (including still buffered ones)
+        std::size_t bytesWritten() const { return _flushed + _used; }
+
+    private:
+        /// @brief Descriptor of output file
+        int _fd = -1;
+        /// @brief Output buffer
+        std::unique_ptr<char[]> _buffer;
+        /// @brief Number of bytes used in _buffer
+        std::size_t _used = 0;
+        /// @brief Number of bytes already written to file
+        std::size_t _flushed = 0;
+    };
+} // quant
+
+#endif //ORDER_BOOK_CSVWRITER_H
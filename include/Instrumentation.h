@@ -0,0 +1,158 @@
+#ifndef ORDER_BOOK_INSTRUMENTATION_H
+#define ORDER_BOOK_INSTRUMENTATION_H
+
+/**
+ * @file    Instrumentation.h
+ * @brief   Optional latency histograms per action and side and counters of internal events of Order Book
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "Pattern.h"
+
+/// @comment Instrumentation exists only if project is configured with -DORDER_BOOK_INSTRUMENTATION=ON,
+///          otherwise macros below expand to nothing and hot path is the same as without this header
+#ifdef ORDER_BOOK_INSTRUMENTATION
+#define ORDER_BOOK_COUNT(event, n) ::quant::instrumentation::count(::quant::Event::event, (n))
+#define ORDER_BOOK_TIME_ACTION(tick) const ::quant::instrumentation::ActionTimer actionTimer(tick)
+#else
+#define ORDER_BOOK_COUNT(event, n) static_cast<void>(0)
+#define ORDER_BOOK_TIME_ACTION(tick) static_cast<void>(0)
+#endif
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @enum Internal events which can explain long ticks
+    enum class Event : std::size_t {
+        levelCreated,   ///< new price level in ladder
+        levelDeleted,   ///< price level removed from ladder
+        ladderShift,    ///< rungs moved by insert or erase not at the best price
+        poolGrowth,     ///< slab of Orders reallocated
+        indexRehash,    ///< index of Orders by ID rehashed
+        COUNT
+    };
+
+    /**
+     * @class LatencyHistogram
+     * @brief HDR-style histogram - exact below 64, above that 32 sub-buckets per power of 2 (error below 3.2%)
+     */
+    class LatencyHistogram {
+    public:
+        /// @brief Number of sub-buckets per power of 2 as bits
+        static constexpr unsigned SUB_BITS = 5;
+        /// @brief Number of sub-buckets per power of 2
+        static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BITS;
+        /// @brief Number of buckets covering whole uint64_t
+        static constexpr std::size_t BUCKETS = (64 - SUB_BITS) * SUB_BUCKETS;
+
+        /**
+         * @brief Add one value
+         * @param value Latency in nanoseconds
+         */
+        void record(uint64_t value);
+
+        /**
+         * @brief Add all values of other histogram
+         * @param other Histogram to merge
+         */
+        void merge(const LatencyHistogram& other);
+
+        /**
+         * @brief Value below which given part of values is
+         * @param quantile Value from 0 to 1, ex. 0.999 for p99.9
+         * @return The highest value equivalent to bucket of quantile, never above max
+         */
+        uint64_t percentile(double quantile) const;
+
+        uint64_t count() const { return _count; }
+        uint64_t max() const { return _max; }
+        double mean() const { return _count == 0 ? 0.0 : static_cast<double>(_sum) / static_cast<double>(_count); }
+
+    private:
+        static std::size_t bucketOf(uint64_t value);
+        static uint64_t highestOf(std::size_t bucket);
+
+        /// @brief Number of values per bucket
+        std::array<uint64_t, BUCKETS> _buckets{};
+        /// @brief Number of all values
+        uint64_t _count = 0;
+        /// @brief Sum of all values for mean
+        uint64_t _sum = 0;
+        /// @brief The highest value
+        uint64_t _max = 0;
+    };
+
+    /// @namespace "instrumentation" for statistics collected by ORDER_BOOK_* macros
+    namespace instrumentation {
+        /// @brief Actions in order of @enum Action, used as index of histograms
+        constexpr std::array<Action, 5> ACTIONS = {Action::clear1, Action::clear2, Action::add, Action::modify,
+                                                   Action::remove};
+
+        /// @struct Statistics collected by one thread
+        struct Stats {
+            /// @brief Latency of runActions per action and side: index is action * 2 + side (bid 0, ask 1)
+            std::array<LatencyHistogram, ACTIONS.size() * 2> latency;
+            /// @brief Counters of @enum Event
+            std::array<uint64_t, static_cast<std::size_t>(Event::COUNT)> events{};
+        };
+
+        /**
+         * @brief Statistics of calling thread, made on first use and kept after thread ends
+         */
+        Stats& local();
+
+        /**
+         * @brief Increase counter of event of calling thread
+         * @param event Type of event
+         * @param n Number of events
+         */
+        inline void count(Event event, uint64_t n) {
+            local().events[static_cast<std::size_t>(event)] += n;
+        }
+
+        /**
+         * @brief Add latency of one tick to histogram of its action and side
+         * @param tick Processed tick
+         * @param nanoseconds Duration of runActions
+         */
+        void record(const Pattern& tick, uint64_t nanoseconds);
+
+        /**
+         * @brief Statistics of all threads merged together
+         */
+        Stats collect();
+
+        /**
+         * @brief Print counts, p50/p99/p99.9/max per action and side and event counters of all threads
+         * @param output Stream for report, ex. std::cout
+         */
+        void report(std::ostream& output);
+
+        /**
+         * @class ActionTimer
+         * @brief Measures lifetime of scope as latency of given tick - tick is read when scope ends
+         */
+        class ActionTimer {
+        public:
+            explicit ActionTimer(const Pattern& tick) : _tick(tick), _start(std::chrono::steady_clock::now()) {}
+            ActionTimer(const ActionTimer&) = delete;
+            ActionTimer& operator=(const ActionTimer&) = delete;
+            ~ActionTimer() {
+                auto duration = std::chrono::steady_clock::now() - _start;
+                record(_tick, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+            }
+
+        private:
+            const Pattern& _tick;
+            std::chrono::steady_clock::time_point _start;
+        };
+    } // instrumentation
+} // quant
+
+#endif //ORDER_BOOK_INSTRUMENTATION_H
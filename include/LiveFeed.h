@@ -0,0 +1,137 @@
+#ifndef ORDER_BOOK_LIVEFEED_H
+#define ORDER_BOOK_LIVEFEED_H
+
+/**
+ * @file    LiveFeed.h
+ * @brief   Live input - the same 26-byte records received from UNIX domain socket, UDP (multicast) or stdin/FIFO
+ *          instead of mapped input file, and sending side used by replay tool
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @enum Transport of live feed
+    enum class FeedKind : uint8_t { unixSocket, udp, pipe };
+
+    /// @struct Parsed address of live feed
+    struct FeedAddress {
+        FeedKind kind = FeedKind::pipe;
+        /// @brief Path of UNIX socket or FIFO, empty for stdin/stdout
+        std::string path;
+        /// @brief IPv4 address of UDP feed - multicast group or unicast address
+        std::string host;
+        uint16_t port = 0;
+    };
+
+    /**
+     * @brief Parse address of live feed, throws std::invalid_argument if it isn't valid
+     * @param address "unix:PATH", "udp:ADDRESS:PORT", "fifo:PATH" or "-" for stdin/stdout
+     */
+    FeedAddress parseFeed(const std::string& address);
+
+    /// @struct Counters of received input
+    struct FeedStats {
+        /// @brief Number of read/recvmmsg calls which returned data
+        uint64_t reads = 0;
+        /// @brief Number of received bytes
+        uint64_t bytes = 0;
+        /// @brief Bytes which aren't part of any complete record - tail of datagram or of stream at its end
+        uint64_t dropped = 0;
+    };
+
+    /**
+     * @brief Receiving side of live feed - returns complete records, however they were split by transport
+     * @comment Stream transports (UNIX socket, stdin/FIFO) are read with large read calls. Incomplete record at the
+     *          end of read is moved to the beginning of buffer and completed by the next read. UDP is read with
+     *          recvmmsg - each datagram has to carry whole records, empty datagram ends the feed. UNIX socket is
+     *          created by FeedSource and one sender is accepted. Signal interrupting blocking call ends the feed.
+     */
+    class FeedSource {
+    public:
+        /// @brief Bytes requested by one read call of stream transport
+        static constexpr std::size_t READ_SIZE = 1 << 16;
+        /// @brief Datagrams received by one recvmmsg call
+        static constexpr std::size_t DATAGRAMS = 64;
+        /// @brief The largest accepted datagram
+        static constexpr std::size_t MAX_DATAGRAM = 1 << 13;
+
+        /**
+         * @brief Open feed, throws std::system_error if it can't be opened. UNIX socket waits for sender in
+         *        the first @fn receive
+         * @param address Parsed address of feed
+         */
+        explicit FeedSource(const FeedAddress& address);
+        FeedSource(const FeedSource&) = delete;
+        FeedSource& operator=(const FeedSource&) = delete;
+        ~FeedSource();
+
+        /**
+         * @brief Block until at least one complete record is received, throws std::system_error on error
+         * @param records Set to the first byte of the first record, valid until the next call
+         * @return Number of complete records, 0 at the end of feed
+         */
+        std::size_t receive(const unsigned char*& records);
+
+        /// @brief Counters of received input
+        const FeedStats& stats() const { return _stats; }
+
+    private:
+        /// @brief Accept sender of UNIX socket, false if interrupted
+        bool accept();
+        std::size_t receiveStream(const unsigned char*& records);
+        std::size_t receiveDatagrams(const unsigned char*& records);
+
+        FeedAddress _address;
+        /// @brief Descriptor which is read - connection, UDP socket or pipe
+        int _fd = -1;
+        /// @brief Listening UNIX socket, closed when sender is accepted
+        int _listenFd = -1;
+        /// @brief Stream: partial record + READ_SIZE bytes, UDP: DATAGRAMS slots of MAX_DATAGRAM bytes
+        std::vector<unsigned char> _buffer;
+        /// @brief Stream only - offset and size of incomplete record left by previous read
+        std::size_t _partialOffset = 0;
+        std::size_t _partialSize = 0;
+        bool _ended = false;
+        FeedStats _stats;
+    };
+
+    /// @brief Sending side of live feed - connects to FeedSource and writes records
+    class FeedSink {
+    public:
+        /// @brief Records in one UDP datagram - datagram fits in Ethernet frame
+        static constexpr std::size_t RECORDS_PER_DATAGRAM = 56;
+
+        /**
+         * @brief Connect to feed, throws std::system_error if it fails. UNIX socket is retried until
+         *        FeedSource creates it or timeout passes
+         * @param address Parsed address of feed
+         * @param connectTimeoutMs Time of waiting for UNIX socket
+         */
+        explicit FeedSink(const FeedAddress& address, unsigned connectTimeoutMs = 5000);
+        FeedSink(const FeedSink&) = delete;
+        FeedSink& operator=(const FeedSink&) = delete;
+        ~FeedSink();
+
+        /**
+         * @brief Send whole records, throws std::system_error on error
+         * @param records The first byte of the first record
+         * @param count Number of records - UDP splits them into datagrams of RECORDS_PER_DATAGRAM records
+         */
+        void send(const unsigned char* records, std::size_t count);
+
+        /// @brief Mark the end of feed - empty datagram for UDP, closing of descriptor for streams
+        void close();
+
+    private:
+        FeedAddress _address;
+        int _fd = -1;
+    };
+} // quant
+
+#endif //ORDER_BOOK_LIVEFEED_H
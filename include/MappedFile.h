@@ -0,0 +1,58 @@
+#ifndef ORDER_BOOK_MAPPEDFILE_H
+#define ORDER_BOOK_MAPPEDFILE_H
+
+/**
+ * @file    MappedFile.h
+ * @brief   Read-only memory mapping of whole file - pages are loaded by kernel only when they are touched
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <string>
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Owner of read-only mapping of file
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        /**
+         * @brief Map whole file, throws std::system_error if file can't be open or mapped
+         * @param path Path to file
+         * @param sequential Advise kernel that file will be read once from the beginning (MADV_SEQUENTIAL)
+         */
+        explicit MappedFile(const std::string& path, bool sequential = true);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        /// @brief First byte of file, nullptr for empty file
+        const unsigned char* data() const { return _data; }
+
+        /// @brief Size of file in bytes
+        std::size_t size() const { return _size; }
+
+        /**
+         * @brief Give back to kernel pages which won't be read again - keeps resident memory bounded
+         * @param bytes Number of bytes from the beginning of file which are already processed
+         */
+        void release(std::size_t bytes);
+
+    private:
+        /// @brief Unmap file if it's mapped
+        void close();
+
+        /// @brief First byte of mapping
+        const unsigned char* _data = nullptr;
+        /// @brief Size of mapped file in bytes
+        std::size_t _size = 0;
+        /// @brief Bytes from the beginning of file already given back to kernel
+        std::size_t _released = 0;
+    };
+} // quant
+
+#endif //ORDER_BOOK_MAPPEDFILE_H
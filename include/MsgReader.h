@@ -8,37 +8,24 @@
  * @mail    m.piwowar2@gmail.com
  */
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <chrono>
+#include "BatchDecoder.h"
+#include "Book.h"
+#include "BookView.h"
+#include "Instrumentation.h"
 #include "OrderBook.h"
+#include "Pattern.h"
+#include "RowFilter.h"
 
 /// @namespace "quant" for Quant Sky dedicated solution
 namespace quant {
-    /// @enum To cover pure digits 1 and 2 and better understanding if we check bid or ask
-    enum Side : uint8_t { bid = '1', ask = '2' };
-
-    /// @enum To cover pure characters and better understanding which action is processed
-    enum Action : uint8_t { clear1 = 'Y', clear2 = 'F', add = 'A', modify = 'M', remove = 'D' };
-
-    /// @struct Pattern for correct reading input binary files and store data per tick
-    struct Pattern {
-        uint64_t SourceTime;
-        uint8_t Side;
-        uint8_t Action;
-        uint64_t OrderId;
-        uint32_t Price;
-        uint32_t Qty;
-        uint32_t B0 = UINT32_MAX;
-        uint32_t BQ0 = UINT32_MAX;
-        uint32_t BN0 = UINT32_MAX;
-        uint32_t A0 = UINT32_MAX;
-        uint32_t AQ0 = UINT32_MAX;
-        uint32_t AN0 = UINT32_MAX;
-    };
-
      /**
       * @brief Function to reading binary file and store input data to Order (tick)
       * @param inputFile Binary file already open
@@ -47,70 +34,243 @@ namespace quant {
 
     /**
      * @brief Dedicated steps for clearing Order Book action
-     * @tparam bidHeap heap for bids where the highest value has the highest priority
-     * @tparam askHeap heap for asks where the lowest value has the highest priority
-     * @param bidOrderBook Order Book dedicated to bid prices and logic
-     * @param askOrderBook Order Book dedicated to ask prices and logic
-     * @param tick Struct to store data per tick
+     * @param book Both sides of Order Book
      */
-    template<typename bidHeap, typename askHeap>
-    static void processClear(OrderBook<bidHeap>& bidOrderBook, OrderBook<askHeap>& askOrderBook);
+    inline void processClear(Book& book) {
+        book.clearAll();
+    }
 
     /**
      * @brief Dedicated steps for adding Order (tick) to Order Book action
-     * @tparam heap bidHeap or askHeap
+     * @tparam side Side::bid or Side::ask
      * @param orderBook Dedicated Order Book
      * @param tick Struct to store data per tick
      */
-    template<typename heap>
-    static void processAdd(OrderBook<heap>& orderBook, Pattern& tick);
+    template<Side side>
+    static void processAdd(OrderBook<side>& orderBook, Pattern& tick) {
+        orderBook.addOrder(tick.OrderId, tick.Price, tick.Qty);  // Adding unique Price
+    }
 
     /**
      * @brief Dedicated steps for modifying Order (tick) inside Order Book action
-     * @tparam heap bidHeap or askHeap
+     * @tparam side Side::bid or Side::ask
      * @param orderBook Dedicated Order Book
      * @param tick Struct to store data per tick
      */
-    template<typename heap>
-    static void processModify(OrderBook<heap>& orderBook, Pattern& tick);
+    /// @comment From delivered instruction - modify of not existing Order is processed like @fn processAdd
+    template<Side side>
+    static void processModify(OrderBook<side>& orderBook, Pattern& tick) {
+        orderBook.modifyOrder(tick.OrderId, tick.Price, tick.Qty);  // Moves Order if price is changed
+    }
 
     /**
      * @brief Dedicated steps for removing Order (tick) from Order Book action
-     * @tparam heap bidHeap or askHeap
+     * @tparam side Side::bid or Side::ask
      * @param orderBook Dedicated Order Book
      * @param tick Struct to store data per tick
      */
-    template<typename heap>
-    static void processRemove(OrderBook<heap>& orderBook, Pattern& tick);
+    template<Side side>
+    static void processRemove(OrderBook<side>& orderBook, Pattern& tick) {
+        orderBook.popOrder(tick.OrderId);                        // Removes price if it's needed
+    }
 
     /**
      * @brief Process to write data to given tick
-     * @tparam bidHeap heap for bids where the highest value has the highest priority
-     * @tparam askHeap heap for asks where the lowest value has the highest priority
-     * @param bidOrderBook Order Book dedicated to bid prices and logic
-     * @param askOrderBook Order Book dedicated to ask prices and logic
+     * @param book Both sides of Order Book - its last written top of book is updated
      * @param tick Struct to store data per tick
+     * @return TopChange bits of sides whose best level differs from the one written to previous tick
+     */
+    inline uint8_t processTick(Book& book, Pattern& tick) {
+        Quote bid, ask;
+        if (book.bidOrderBook.isAnyPrice()) {
+            bid = Quote{book.bidOrderBook.bestPrice(), book.bidOrderBook.getBestShares(),
+                        book.bidOrderBook.getBestOrders()};
+        }
+        if (book.askOrderBook.isAnyPrice()) {
+            ask = Quote{book.askOrderBook.bestPrice(), book.askOrderBook.getBestShares(),
+                        book.askOrderBook.getBestOrders()};
+        }
+        tick.B0 = bid.Price;
+        tick.BQ0 = bid.Qty;
+        tick.BN0 = bid.Orders;
+        tick.A0 = ask.Price;
+        tick.AQ0 = ask.Qty;
+        tick.AN0 = ask.Orders;
+
+        uint8_t changed = topUnchanged;
+        if (bid != book.bidTop) changed |= bidTopChanged;
+        if (ask != book.askTop) changed |= askTopChanged;
+        book.bidTop = bid;
+        book.askTop = ask;
+        return changed;
+    }
+
+    /**
+     * @brief Process to write deeper levels (1..depth-1) of both sides after given tick
+     * @param book Both sides of Order Book
+     * @param depth Number of levels per side
+     * @param levels 2 * (depth - 1) elements: bid levels followed by ask levels
      */
-    template<typename bidHeap, typename askHeap>
-    static void processTick(OrderBook<bidHeap>& bidOrderBook, OrderBook<askHeap>& askOrderBook, Pattern& tick);
+    /// @comment Level 0 is already written by @fn processTick - here only levels 1..depth-1 are taken
+    inline void processDepth(const Book& book, std::size_t depth, Quote* levels) {
+        for (std::size_t level = 1; level < depth; ++level) {
+            Quote& bid = levels[level - 1];
+            Quote& ask = levels[depth - 1 + level - 1];
+            if (level < book.bidOrderBook.noLevels()) {
+                const Level& bidLevel = book.bidOrderBook.levelAt(level);
+                bid = Quote{bidLevel.price, bidLevel.shares, bidLevel.orders};
+            }
+            else bid = Quote{};
+            if (level < book.askOrderBook.noLevels()) {
+                const Level& askLevel = book.askOrderBook.levelAt(level);
+                ask = Quote{askLevel.price, askLevel.shares, askLevel.orders};
+            }
+            else ask = Quote{};
+        }
+    }
+
+    /// @enum Operations run by @fn runActions - both clear actions are the same operation
+    enum class Operation : uint8_t { ignore, clear, add, modify, remove };
+
+    /// @brief Operation of every value of Action byte
+    constexpr std::array<Operation, 256> OPERATIONS = [] {
+        std::array<Operation, 256> operations{};
+        operations[Action::clear1] = Operation::clear;
+        operations[Action::clear2] = Operation::clear;
+        operations[Action::add] = Operation::add;
+        operations[Action::modify] = Operation::modify;
+        operations[Action::remove] = Operation::remove;
+        return operations;
+    }();
+
+    /// @brief Index of every value of Side byte - 0 for unknown side, 1 for bid, 2 for ask
+    constexpr std::array<uint8_t, 256> SIDE_INDEXES = [] {
+        std::array<uint8_t, 256> indexes{};
+        indexes[Side::bid] = 1;
+        indexes[Side::ask] = 2;
+        return indexes;
+    }();
+
+    /**
+     * @brief Dense code of action and side - small consecutive values, so switch over it is one jump table
+     * @param action Action byte of tick
+     * @param side Side byte of tick
+     */
+    constexpr std::size_t dispatchCode(uint8_t action, uint8_t side) {
+        return static_cast<std::size_t>(OPERATIONS[action]) * 3 + SIDE_INDEXES[side];
+    }
 
     /**
      * @brief Part of code responsible for run correct actions and run ticks for Order Book
-     * @tparam bidHeap heap for bids where the highest value has the highest priority
-     * @tparam askHeap heap for asks where the lowest value has the highest priority
-     * @param bidOrderBook Order Book dedicated to bid prices and logic
-     * @param askOrderBook Order Book dedicated to ask prices and logic
+     * @param book Both sides of Order Book
      * @param tick Struct to store data per tick
+     * @return TopChange bits returned by @fn processTick, topUnchanged for unknown action
      */
-    template<typename bidHeap, typename askHeap>
-    static void runActions(OrderBook<bidHeap>& bidOrderBook, OrderBook<askHeap>& askOrderBook, Pattern& tick);
+    /// @comment Side is resolved by dispatch code, so each case calls Order Book of known side and is inlined
+    inline uint8_t runActions(Book& book, Pattern& tick) {
+        ORDER_BOOK_TIME_ACTION(tick);
+        switch (dispatchCode(tick.Action, tick.Side)) {
+            case dispatchCode(Action::clear1, 0):               // clear2 has the same codes
+            case dispatchCode(Action::clear1, Side::bid):
+            case dispatchCode(Action::clear1, Side::ask):
+                processClear(book);
+                break;
+            case dispatchCode(Action::add, Side::bid):
+                processAdd(book.bidOrderBook, tick);
+                break;
+            case dispatchCode(Action::add, Side::ask):
+                processAdd(book.askOrderBook, tick);
+                break;
+            case dispatchCode(Action::modify, Side::bid):
+                processModify(book.bidOrderBook, tick);
+                break;
+            case dispatchCode(Action::modify, Side::ask):
+                processModify(book.askOrderBook, tick);
+                break;
+            case dispatchCode(Action::remove, Side::bid):
+                processRemove(book.bidOrderBook, tick);
+                break;
+            case dispatchCode(Action::remove, Side::ask):
+                processRemove(book.askOrderBook, tick);
+                break;
+            case dispatchCode(Action::add, 0):                  // unknown side - only result is written
+            case dispatchCode(Action::modify, 0):
+            case dispatchCode(Action::remove, 0):
+                break;
+            default:
+                return topUnchanged;
+        }
+        return processTick(book, tick);
+    }
 
     /**
-     * @brief Function responsible for return tick data to CSV file
+     * @brief Function responsible for return tick data to CSV file - kept as reference for CsvWriter
      * @param tick Struct to store data per tick
      */
     std::string printCSV(Pattern& tick);
 
+    /// @struct Bounded part of input passed between steps of streaming pipeline
+    struct TickBatch {
+        static constexpr std::size_t CAPACITY = 4096;
+        /// @brief Index of the first tick of batch in input file
+        std::size_t first = 0;
+        std::size_t size = 0;
+        /// @brief Records decoded by decode step, turned into ticks by Order Book step
+        TickColumns columns;
+        std::array<Pattern, CAPACITY> ticks;
+        /// @brief TopChange bits of each tick
+        std::array<uint8_t, CAPACITY> changes;
+        /// @brief 2 * (depth - 1) deeper levels per tick, empty if only level 0 is written
+        std::vector<Quote> levels;
+    };
+
+    /// @enum Format of output file
+    enum class OutputFormat : uint8_t { csv, binary };
+
+    /// @struct Settings of MsgReader
+    struct ReaderOptions {
+        /// @brief Input binary file
+        std::string inputFile = INPUT_FILE;
+        /// @brief Output file - if empty, OUTPUT_FILE or BINARY_OUTPUT_FILE depending on format
+        std::string outputFile;
+        /// @brief Write CSV to OUTPUT_FILE or binary records to BINARY_OUTPUT_FILE
+        OutputFormat format = OutputFormat::csv;
+        /// @brief Number of levels per side written for each tick (1..MAX_DEPTH)
+        std::size_t depth = 1;
+        /// @brief Streaming only - decode and write on separate threads connected with Order Book by lock-free queues
+        bool threaded = false;
+        /// @brief Directory of snapshots of Order Book
+        std::string checkpointDir = CHECKPOINT_DIR;
+        /// @brief Write snapshot of Order Book to checkpointDir after each given number of ticks, 0 turns it off
+        std::size_t checkpointEvery = 0;
+        /// @brief Write snapshot of Order Book to checkpointDir after each clear action
+        bool checkpointOnClear = false;
+        /// @brief Load the latest snapshot from checkpointDir and process only ticks after it
+        bool resume = false;
+        /// @brief Don't print anything on console - used when many files are processed at once
+        bool quiet = false;
+        /// @brief Orders and price levels of each side allocated before the first tick
+        BookCapacity capacity;
+        /// @brief Which ticks are written - all, changes of top of book or conflated changes
+        OutputFilter filter = OutputFilter::all;
+        /// @brief Conflated output only - minimal distance of SourceTime between rows changing the same side
+        uint64_t conflateInterval = 0;
+        /// @brief If set, top of book is published there after each tick for reader threads
+        BookView* view = nullptr;
+        /// @brief Live only - address of feed parsed by @fn parseFeed, used instead of inputFile
+        std::string feed;
+    };
+
+    /// @struct Result of processing of one input file
+    struct ReplayStats {
+        /// @brief Number of processed ticks
+        std::size_t ticks = 0;
+        /// @brief Number of rows written to output - lower than ticks if output is filtered
+        std::size_t rows = 0;
+        /// @brief Time of building Order Book only
+        std::chrono::nanoseconds buildTime{0};
+    };
+
     /// @brief Class responsible for reading input files, processing ticks, and writing to output file
     class MsgReader {
     public:
@@ -121,8 +281,81 @@ namespace quant {
         MsgReader& operator=(MsgReader&&) noexcept = default;
         ~MsgReader() = default;
 
-        /// @brief Function realising task of class
-        static void read();
+        /**
+         * @brief Function realising task of class
+         * @param options Settings of processing
+         * @return Number of ticks and time of building Order Book
+         */
+        static ReplayStats read(const ReaderOptions& options = {});
+
+        /**
+         * @brief Scripted scenario of price moves - Orders moved between levels by modify, qty-only modifies, modify
+         *        of unknown Order and replacing add. After each step every level of both sides (shares, Orders)
+         *        and queue positions of touched Orders are compared with expected ones. Result is printed
+         * @return True if every step gives expected book
+         */
+        static bool checkPriceMoves();
+
+        /**
+         * @brief Scripted sequence of top of book changes passed through conflating RowFilter - changes written at
+         *        once, held back, released by later tick or by finish, time going back. Rows written after each
+         *        tick are compared with expected ones (SourceTime and deeper levels of written tick). Result is printed
+         * @return True if every tick gives expected rows
+         */
+        static bool checkConflation();
+
+        /**
+         * @brief Same result as @fn read, but decode, build and write run one after another over bounded batches,
+         *        so memory doesn't depend on size of input file and output appears during processing
+         * @param options Settings of processing
+         * @return Number of ticks and time of building Order Book
+         */
+        static ReplayStats stream(const ReaderOptions& options = {});
+
+        /**
+         * @brief Same output as @fn stream, but records are received from live feed (options.feed) until it ends or
+         *        SIGINT/SIGTERM comes. Every receive is processed and written at once - rows are flushed after it.
+         *        Time from receive to publishing of the last tick of it is reported. Resume isn't supported
+         * @param options Settings of processing
+         * @return Number of ticks and time of building Order Book
+         */
+        static ReplayStats live(const ReaderOptions& options);
+
+        /**
+         * @brief Synthetic multi-instrument replay - input file is repeated as given number of instruments,
+         *        encoded as extended records and processed by BookManager. Only throughput is reported
+         * @param options Settings of processing - only input file is used
+         * @param instruments Number of instruments
+         * @param workers Number of worker threads
+         */
+        static void replayInstruments(const ReaderOptions& options, std::size_t instruments, std::size_t workers);
+
+        /**
+         * @brief Decode whole input file with every decoder supported by CPU and compare it bit by bit
+         *        with @fn readBinaryFile. First difference is printed
+         * @param options Settings of processing - only input file is used
+         * @return True if all decoders agree with readBinaryFile
+         */
+        static bool checkDecoders(const ReaderOptions& options = {});
+
+        /**
+         * @brief Resume from snapshot against uninterrupted run - input file is processed once without snapshots
+         *        and once with snapshot in the middle, output of the latter is cut and processing is resumed.
+         *        Both outputs are compared byte by byte, for @fn read and @fn stream. Result is printed
+         * @param options Settings of processing - input file, format, depth, threaded and capacity are used
+         * @return True if resumed outputs are the same as uninterrupted ones
+         */
+        static bool checkResume(const ReaderOptions& options = {});
+
+        /**
+         * @brief Stress of BookView - reader threads poll view while it is published by synthetic writer and by
+         *        replay of input file, every snapshot read is checked for torn values. Result is printed
+         * @param options Settings of replay - depth is used as depth of view, output is discarded (/dev/null),
+         *        snapshots are neither loaded nor written
+         * @param readers Number of reader threads
+         * @return True if no reader saw inconsistent snapshot
+         */
+        static bool stressView(const ReaderOptions& options, std::size_t readers);
     };
 } // quant
 
@@ -8,27 +8,53 @@
  * @mail    m.piwowar2@gmail.com
  */
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
-#include <unordered_map>
-#include <unordered_set>
-#include <queue>
+#include <optional>
+#include <vector>
+
+#include "Instrumentation.h"
+#include "OrderIndex.h"
+#include "OrderPool.h"
+#include "Pattern.h"
+#include "PriceLevels.h"
 
 /// @namespace "quant" for Quant Sky dedicated solution
 namespace quant {
+    /// @struct Place of Order inside FIFO queue of its price level
+    struct QueuePosition {
+        uint32_t ordersAhead;
+        uint64_t sharesAhead;
+    };
+
+    /// @struct New state of price level changed by last actions - orders equal 0 means that level was removed
+    struct LevelChange {
+        uint32_t price;
+        uint32_t shares;
+        uint32_t orders;
+    };
+
+    /// @struct Startup capacity of one side of Order Book - nothing is allocated on hot path until it is exceeded.
+    ///         Defaults are small and storage grows on demand, expected size of session has to be given explicitly
+    struct BookCapacity {
+        /// @brief Maximal number of Orders standing at once
+        std::size_t orders = OrderPool::DEFAULT_CAPACITY;
+        /// @brief Maximal number of price levels at once
+        std::size_t levels = PriceLevels<Side::bid>::DEFAULT_CAPACITY;
+    };
+
     /**
-     * @brief Two types of heap used as types to create Order Book got bid or ask
-     * @param bidHeap -> heap for bids where the highest value has the highest priority
-     * @param askHeap -> heap for asks where the lowest value has the highest priority
+     * @brief Class creating Order Book of one side
+     * @tparam side Side::bid or Side::ask - order of prices and sentinel of empty side come from SideTraits
      */
-    using bidHeap = std::priority_queue<uint32_t>;
-    using askHeap = std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>>;
-
-    /// @brief Class creating Order Book with one of types of heap
-    template<typename heap>
+    template<Side side>
     class OrderBook {
     public:
-        OrderBook() = default;
+        /**
+         * @param capacity Orders and price levels allocated up front
+         */
+        explicit OrderBook(const BookCapacity& capacity = BookCapacity{}) { reserve(capacity); }
         OrderBook(const OrderBook&) = default;
         OrderBook& operator=(const OrderBook&) = default;
         OrderBook(OrderBook&&) noexcept = default;
@@ -42,84 +68,385 @@ namespace quant {
         void addPrice(uint32_t price);
 
         /**
-         * @brief Method to remove price - once removed price is not available, because only uniques are stored
+         * @brief Method to remove price together with all Orders on it
          * @param price - any value of type uint32_t (bid or ask)
          */
         void popPrice(uint32_t price);
 
-        /// @brief Return top of heap
-        uint32_t bestPrice();
+        /// @brief Return the best price level or SideTraits<side>::WORST_PRICE if there is no level
+        uint32_t bestPrice() const;
 
-        /// @brief Remove top of heap
+        /// @brief Remove the best price level together with all Orders on it
         void popBestPrice();
 
         /**
-         * @brief Add Order type to map with given key
-         * @param orderID key to map
-         * @param order value to key
+         * @brief Add Order at the end of FIFO queue of given price, level totals are updated in O(1)
+         * @param orderID unique ID of Order
+         * @param price price level of Order
+         * @param qty number of shares of the Order
+         * @return Handle of the Order - valid until the Order is removed
          */
-        void addOrder(uint64_t orderID, uint32_t order);
+        OrderHandle addOrder(uint64_t orderID, uint32_t price, uint32_t qty);
 
         /**
-         * @brief Remove Order from a map
+         * @brief Change price and quantity of existing Order, both old and new level totals are updated
+         * @param orderID unique ID of Order
+         * @param price new price level of Order
+         * @param qty new number of shares of the Order
+         * @return Handle of the Order - valid until the Order is removed
+         */
+        OrderHandle modifyOrder(uint64_t orderID, uint32_t price, uint32_t qty);
+
+        /**
+         * @brief Remove Order from FIFO queue of its price level, level totals are updated in O(1)
          * @param orderID key to remove a value
          */
         void popOrder(uint64_t orderID);
 
         /**
-         * @brief Add OrderID to the unique set of orders with same price
-         * @param price key to map of sets
-         * @param orderID value to store in unique set of orders with same price (key)
+         * @brief Remove Order by its handle without looking up OrderID
+         * @param handle value returned earlier by addOrder or findOrder
          */
-        void addOrderToGroup(uint32_t price, uint64_t orderID);
+        void cancelOrder(OrderHandle handle);
 
         /**
-         * @brief Remove OrderID from set
-         * @param price key to set of OrderIDs
-         * @param orderID value to remove
+         * @brief Returning handle of Order
+         * @param orderID unique ID of Order
+         * @return Handle of the Order or NO_HANDLE if Order doesn't exist
          */
-        void popOrderFromGroup(uint32_t price, uint64_t orderID);
+        OrderHandle findOrder(uint64_t orderID) const;
+
+        /// @brief Access to the Order record, handle has to be valid
+        const Order& order(OrderHandle handle) const { return _pool[handle]; }
+
+        /**
+         * @brief Returning number of Orders and shares standing in front of given Order at its price level
+         * @param orderID unique ID of Order
+         */
+        std::optional<QueuePosition> queuePosition(uint64_t orderID) const;
 
         /**
          * @brief Returning number of Orders in Order Book related to given price
          * @param price Given price to check (bid/ask)
          */
-        uint32_t noOrders(uint32_t price);
+        uint32_t noOrders(uint32_t price) const;
 
         /**
          * @brief Returning number of all shares (Qty) in Order Book related to given price
          * @param price Given price to check (bid/ask)
          */
-        uint32_t noShares(uint32_t price);
+        uint32_t noShares(uint32_t price) const;
 
         /// @brief Returning number of all Orders in Order Book related to the best price
-        uint32_t getBestOrders();
+        uint32_t getBestOrders() const;
 
         /// @brief Returning number of all shares (Qty) in Order Book related to the best price
-        uint32_t getBestShares();
+        uint32_t getBestShares() const;
+
+        /// @brief Returning number of price levels
+        std::size_t noLevels() const { return _levels.size(); }
+
+        /**
+         * @brief Return level at given distance from the best one - no sorting or copying of the book
+         * @param depth 0 for the best level, has to be lower than noLevels()
+         */
+        const Level& levelAt(std::size_t depth) const { return _levels.atDepth(depth); }
+
+        /**
+         * @brief Copy the best levels
+         * @param depth Maximal number of levels to copy
+         * @param quotes At least depth elements, levels which don't exist are left untouched
+         * @return Number of copied levels
+         */
+        std::size_t topLevels(std::size_t depth, Quote* quotes) const;
+
+        /**
+         * @brief Start or stop recording LevelChange of each updated level
+         * @param enabled Recording is off by default, so hot path doesn't pay for it if nobody reads changes
+         */
+        void trackChanges(bool enabled);
+
+        /// @brief Levels updated since last takeChanges or clearAll, in order of updates
+        const std::vector<LevelChange>& changes() const { return _changes; }
+
+        /// @brief Checking if Order Book was cleared since last takeChanges - then consumer has to drop its view
+        bool wasCleared() const { return _cleared; }
 
-        /// @brief clear all poles in Order Book
+        /// @brief Forget recorded changes after consumer applied them
+        void takeChanges();
+
+        /// @brief clear all poles in Order Book in O(1) - storage of Orders, levels and ID index is kept for reuse
         void clearAll();
 
+        /**
+         * @brief Make place for given number of Orders and price levels up front, so hot path doesn't allocate
+         * @param capacity Orders and price levels
+         */
+        void reserve(const BookCapacity& capacity);
+
+        /**
+         * @brief Keep Order IDs from dense range in directly indexed array - has to be set before first Order
+         * @param base The lowest ID of range
+         * @param size Number of IDs in range, 0 turns direct mode off
+         * @return True if range was set, false if side already has Orders
+         */
+        bool directIds(uint64_t base, std::size_t size) { return _orders.directRange(base, size); }
+
         /// @brief Checking if there is any price in Order Book (we store only unique prices)
-        bool isAnyPrice();
+        bool isAnyPrice() const;
 
     private:
-        /// @brief Heap of one of the given types - store prices with declared order
-        heap _heap;
-        /// @brief Set to store only unique prices, which are stored in _heap too
-        std::unordered_set<uint32_t> _uniquePrices;
-        /// @brief Map to store Orders where Order ID is a key
-        std::unordered_map<uint64_t, uint32_t> _orders;
-        /// @brief Map to store set of OrderIDs with same price
-        std::unordered_map<uint32_t, std::unordered_set<uint64_t>> _groupOrders;
-        /// @brief Best price in _heap
-        uint32_t _bestPrice = 0;
-        /// @breif Number of shares (Qty) in Order Book related to best price
-        uint32_t _noShares = 0;
-        /// @brief Number of orders in Order Book related to best price
-        uint32_t _noOrders = 0;
+        /**
+         * @brief Put Order at the tail of FIFO queue of level
+         * @param handle Order already filled with price and qty
+         * @param level level with price of the Order
+         */
+        void link(OrderHandle handle, LevelHandle level);
+
+        /**
+         * @brief Take Order out of FIFO queue of its level, level is removed when it gets empty
+         * @param handle Order linked earlier
+         */
+        void unlink(OrderHandle handle);
+
+        /**
+         * @brief Release all Orders of level and the level itself
+         * @param level level to remove
+         */
+        void eraseLevel(LevelHandle level);
+
+        /**
+         * @brief Record new state of level if changes are tracked
+         * @param level level after update
+         */
+        void recordChange(const Level& level);
+
+        /// @brief Price levels of the side - store unique prices with declared order and level totals
+        PriceLevels<side> _levels;
+        /// @brief Slab with all Order records of this Order Book
+        OrderPool _pool;
+        /// @brief Map from Order ID to Order record
+        OrderIndex _orders;
+        /// @brief Levels changed since last takeChanges
+        std::vector<LevelChange> _changes;
+        /// @brief Flag if _changes are recorded
+        bool _trackChanges = false;
+        /// @brief Flag if Order Book was cleared since last takeChanges
+        bool _cleared = false;
     };
+
+    /// @comment Definitions are in header, so whole hot path can be inlined into replay loop
+
+    /// @comment Only unique prices are stored - should be run always as first method in actions
+    template<Side side>
+    void OrderBook<side>::addPrice(uint32_t price) {
+        _levels.push(price);
+    }
+
+    /// @comment Any level is removed in place - ladder is never rebuilt
+    template<Side side>
+    void OrderBook<side>::popPrice(uint32_t price) {
+        LevelHandle level = _levels.find(price);
+        if (level != NO_HANDLE) eraseLevel(level);
+    }
+
+    /// @comment Empty side returns price which is never better than any other
+    template<Side side>
+    uint32_t OrderBook<side>::bestPrice() const {
+        return _levels.empty() ? SideTraits<side>::WORST_PRICE : _levels.top().price;
+    }
+
+    template<Side side>
+    void OrderBook<side>::popBestPrice() {
+        popPrice(_levels.top().price);
+    }
+
+    /// @comment If orderID already exist -> Order is replaced and goes to the end of queue as a new one
+    template<Side side>
+    OrderHandle OrderBook<side>::addOrder(uint64_t orderID, uint32_t price, uint32_t qty) {
+        auto [value, isNew] = _orders.tryEmplace(orderID, NO_HANDLE);
+        if (isNew) *value = _pool.allocate();
+        else unlink(*value);
+        const OrderHandle handle = *value;
+
+        Order& order = _pool[handle];
+        order.id = orderID;
+        order.price = price;
+        order.qty = qty;
+        link(handle, _levels.push(price));
+        return handle;
+    }
+
+    /// @comment Change of quantity only is updated in place (O(1), Order keeps its place in queue),
+    ///          change of price removes Order from old level and puts it at the end of queue of new level.
+    ///          If orderID doesn't exist -> Order is added
+    template<Side side>
+    OrderHandle OrderBook<side>::modifyOrder(uint64_t orderID, uint32_t price, uint32_t qty) {
+        const OrderHandle handle = _orders.find(orderID);
+        if (handle == NO_HANDLE) return addOrder(orderID, price, qty);
+
+        Order& order = _pool[handle];
+        if (order.price == price) {
+            Level& level = _levels[order.level];
+            level.shares += qty - order.qty;
+            order.qty = qty;
+            recordChange(level);
+            return handle;
+        }
+        unlink(handle);
+        order.price = price;
+        order.qty = qty;
+        link(handle, _levels.push(price));
+        return handle;
+    }
+
+    /// @comment If OrderID doesn't exist, removing will be ignore without exception. Remove also price if needed
+    template<Side side>
+    void OrderBook<side>::popOrder(uint64_t orderID) {
+        const OrderHandle handle = _orders.erase(orderID);
+        if (handle == NO_HANDLE) return;
+        unlink(handle);
+        _pool.release(handle);
+    }
+
+    template<Side side>
+    void OrderBook<side>::cancelOrder(OrderHandle handle) {
+        _orders.erase(_pool[handle].id);
+        unlink(handle);
+        _pool.release(handle);
+    }
+
+    template<Side side>
+    OrderHandle OrderBook<side>::findOrder(uint64_t orderID) const {
+        return _orders.find(orderID);
+    }
+
+    /// @comment Walks queue from the Order towards head of level - cost depends only on number of Orders ahead
+    template<Side side>
+    std::optional<QueuePosition> OrderBook<side>::queuePosition(uint64_t orderID) const {
+        OrderHandle handle = findOrder(orderID);
+        if (handle == NO_HANDLE) return std::nullopt;
+        QueuePosition position{0, 0};
+        for (OrderHandle ahead = _pool[handle].prev; ahead != NO_HANDLE; ahead = _pool[ahead].prev) {
+            ++position.ordersAhead;
+            position.sharesAhead += _pool[ahead].qty;
+        }
+        return position;
+    }
+
+    template<Side side>
+    uint32_t OrderBook<side>::noOrders(uint32_t price) const {
+        LevelHandle level = _levels.find(price);
+        return level != NO_HANDLE ? _levels[level].orders : 0;
+    }
+
+    template<Side side>
+    uint32_t OrderBook<side>::noShares(uint32_t price) const {
+        LevelHandle level = _levels.find(price);
+        return level != NO_HANDLE ? _levels[level].shares : 0;
+    }
+
+    template<Side side>
+    uint32_t OrderBook<side>::getBestOrders() const {
+        return _levels.top().orders;
+    }
+
+    template<Side side>
+    uint32_t OrderBook<side>::getBestShares() const {
+        return _levels.top().shares;
+    }
+
+    template<Side side>
+    std::size_t OrderBook<side>::topLevels(std::size_t depth, Quote* quotes) const {
+        std::size_t count = std::min(depth, _levels.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            const Level& level = _levels.atDepth(i);
+            quotes[i] = Quote{level.price, level.shares, level.orders};
+        }
+        return count;
+    }
+
+    template<Side side>
+    void OrderBook<side>::trackChanges(bool enabled) {
+        _trackChanges = enabled;
+        takeChanges();
+    }
+
+    template<Side side>
+    void OrderBook<side>::takeChanges() {
+        _changes.clear();
+        _cleared = false;
+    }
+
+    /// @comment Nothing is freed or walked - pool and ladder are rewound and ID index starts new epoch,
+    ///          so cost doesn't depend on size of the book and next Orders reuse the same memory
+    template<Side side>
+    void OrderBook<side>::clearAll() {
+        _levels.clear();
+        _pool.clear();
+        _orders.clear();
+        _changes.clear();
+        _cleared = _trackChanges;
+    }
+
+    template<Side side>
+    void OrderBook<side>::reserve(const BookCapacity& capacity) {
+        _levels.reserve(capacity.levels);
+        _pool.reserve(capacity.orders);
+        _orders.reserve(capacity.orders);
+    }
+
+    template<Side side>
+    bool OrderBook<side>::isAnyPrice() const {
+        return !_levels.empty();
+    }
+
+    template<Side side>
+    void OrderBook<side>::link(OrderHandle handle, LevelHandle level) {
+        Order& order = _pool[handle];
+        Level& queue = _levels[level];
+        order.level = level;
+        order.prev = queue.tail;
+        order.next = NO_HANDLE;
+        if (queue.tail != NO_HANDLE) _pool[queue.tail].next = handle;
+        else queue.head = handle;
+        queue.tail = handle;
+        queue.shares += order.qty;
+        ++queue.orders;
+        recordChange(queue);
+    }
+
+    template<Side side>
+    void OrderBook<side>::unlink(OrderHandle handle) {
+        Order& order = _pool[handle];
+        Level& queue = _levels[order.level];
+        if (order.prev != NO_HANDLE) _pool[order.prev].next = order.next;
+        else queue.head = order.next;
+        if (order.next != NO_HANDLE) _pool[order.next].prev = order.prev;
+        else queue.tail = order.prev;
+        queue.shares -= order.qty;
+        --queue.orders;
+        recordChange(queue);
+        if (queue.orders == 0) _levels.erase(order.level);
+    }
+
+    template<Side side>
+    void OrderBook<side>::eraseLevel(LevelHandle level) {
+        OrderHandle handle = _levels[level].head;
+        while (handle != NO_HANDLE) {
+            OrderHandle next = _pool[handle].next;
+            _orders.erase(_pool[handle].id);
+            _pool.release(handle);
+            handle = next;
+        }
+        recordChange(Level{_levels[level].price});
+        _levels.erase(level);
+    }
+
+    template<Side side>
+    void OrderBook<side>::recordChange(const Level& level) {
+        if (_trackChanges) _changes.push_back(LevelChange{level.price, level.shares, level.orders});
+    }
 } // quant
 
 #endif //ORDER_BOOK_ORDERBOOK_H
@@ -0,0 +1,244 @@
+#ifndef ORDER_BOOK_ORDERINDEX_H
+#define ORDER_BOOK_ORDERINDEX_H
+
+/**
+ * @file    OrderIndex.h
+ * @brief   Flat open-addressing map from Order ID to OrderHandle used instead of std::unordered_map
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Instrumentation.h"
+#include "OrderPool.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /**
+     * @brief Linear probing over one array of slots, deletes shift following slots back (no tombstones),
+     *        so probe sequences never grow with number of removed Orders
+     * @comment Order IDs are date followed by sequence number (ex. 20220119023943) - mostly consecutive numbers.
+     *          Fibonacci hashing (one multiply, high bits taken) spreads consecutive keys evenly over table.
+     *          If sequence range is known and dense, IDs inside it can be kept in directly indexed array.
+     *          Every entry is stamped with epoch of index - clear only starts new epoch, so it is O(1) and memory
+     *          is never given back or touched.
+     */
+    class OrderIndex {
+    public:
+        /// @brief Default number of Orders which fit without growing - small, so idle books are cheap (32 KB)
+        static constexpr std::size_t DEFAULT_CAPACITY = 1 << 10;
+
+        /**
+         * @param capacity Number of Orders which fit without growing - table has at least 2 * capacity slots
+         */
+        explicit OrderIndex(std::size_t capacity = DEFAULT_CAPACITY) { reserve(capacity); }
+
+        /**
+         * @brief Make place for given number of Orders up front, so table doesn't grow during session
+         * @param capacity Number of Orders
+         */
+        void reserve(std::size_t capacity);
+
+        /**
+         * @brief Keep IDs from base to base + size - 1 in directly indexed array instead of hash table.
+         *        Can be set only when index is empty
+         * @param base The lowest ID of dense range
+         * @param size Number of IDs in range, 0 turns direct mode off
+         * @return True if range was set, false if index isn't empty - previous range is kept then
+         */
+        bool directRange(uint64_t base, std::size_t size);
+
+        /**
+         * @brief Insert ID if it doesn't exist
+         * @param orderID unique ID of Order
+         * @param handle value stored for new ID
+         * @return Place of value of ID and flag if ID was inserted
+         */
+        std::pair<OrderHandle*, bool> tryEmplace(uint64_t orderID, OrderHandle handle);
+
+        /**
+         * @brief Value of ID
+         * @param orderID unique ID of Order
+         * @return Handle of the Order or NO_HANDLE if ID doesn't exist
+         */
+        OrderHandle find(uint64_t orderID) const;
+
+        /**
+         * @brief Remove ID if it exists
+         * @param orderID unique ID of Order
+         * @return Handle which was stored for ID or NO_HANDLE if ID didn't exist
+         */
+        OrderHandle erase(uint64_t orderID);
+
+        /// @brief Remove all IDs in O(1) - entries of previous epoch become empty, allocated memory is kept
+        void clear();
+
+        /// @brief Returning number of stored IDs
+        std::size_t size() const { return _size; }
+
+        /// @brief Returning number of slots of hash table
+        std::size_t slots() const { return _slots.size(); }
+
+    private:
+        /// @struct Slot of hash table - slot is used only if its epoch is current epoch of index
+        struct Slot {
+            uint64_t orderID;
+            OrderHandle handle;
+            uint32_t epoch;
+        };
+
+        /// @struct Entry of direct range - used only if its epoch is current epoch of index
+        struct DirectSlot {
+            OrderHandle handle;
+            uint32_t epoch;
+        };
+
+        /// @brief Epoch which never becomes current - marks empty slots
+        static constexpr uint32_t EMPTY_EPOCH = 0;
+
+        /// @brief Checking if slot holds ID of current epoch
+        bool used(const Slot& slot) const { return slot.epoch == _epoch; }
+
+        /// @brief Home slot of ID
+        std::size_t home(uint64_t orderID) const {
+            return static_cast<std::size_t>((orderID * 0x9E3779B97F4A7C15ULL) >> _shift);
+        }
+
+        /// @brief Checking if ID belongs to directly indexed range
+        bool isDirect(uint64_t orderID) const { return orderID - _directBase < _direct.size(); }
+
+        /// @brief Double number of slots and put all IDs again
+        void grow();
+
+        /// @brief Hash table, number of slots is power of 2
+        std::vector<Slot> _slots;
+        /// @brief 64 - log2(number of slots)
+        unsigned _shift = 64;
+        /// @brief Number of IDs in hash table when it has to grow (half of slots)
+        std::size_t _limit = 0;
+        /// @brief Number of IDs in hash table
+        std::size_t _hashed = 0;
+        /// @brief Number of all IDs
+        std::size_t _size = 0;
+        /// @brief Handles of IDs from direct range
+        std::vector<DirectSlot> _direct;
+        /// @brief The lowest ID of direct range
+        uint64_t _directBase = 0;
+        /// @brief Current epoch - incremented by each clear
+        uint32_t _epoch = EMPTY_EPOCH + 1;
+    };
+
+    /// @comment Definitions are in header, so lookups are inlined into Order Book
+
+    inline void OrderIndex::reserve(std::size_t capacity) {
+        std::size_t slots = 16;
+        unsigned bits = 4;
+        while (slots < 2 * capacity) {
+            slots <<= 1;
+            ++bits;
+        }
+        if (slots <= _slots.size()) return;
+
+        std::vector<Slot> old(slots, Slot{0, NO_HANDLE, EMPTY_EPOCH});
+        old.swap(_slots);
+        _shift = 64 - bits;
+        _limit = slots / 2;
+        for (const Slot& slot : old) {
+            if (!used(slot)) continue;
+            std::size_t i = home(slot.orderID);
+            while (used(_slots[i])) i = (i + 1) & (_slots.size() - 1);
+            _slots[i] = slot;
+        }
+    }
+
+    inline bool OrderIndex::directRange(uint64_t base, std::size_t size) {
+        if (_size != 0) return false;
+        _directBase = base;
+        _direct.assign(size, DirectSlot{NO_HANDLE, EMPTY_EPOCH});
+        return true;
+    }
+
+    inline void OrderIndex::grow() {
+        ORDER_BOOK_COUNT(indexRehash, 1);
+        reserve(_slots.size());
+    }
+
+    inline std::pair<OrderHandle*, bool> OrderIndex::tryEmplace(uint64_t orderID, OrderHandle handle) {
+        if (isDirect(orderID)) {
+            DirectSlot& value = _direct[orderID - _directBase];
+            if (value.epoch == _epoch) return {&value.handle, false};
+            value = DirectSlot{handle, _epoch};
+            ++_size;
+            return {&value.handle, true};
+        }
+        if (_hashed >= _limit) grow();
+        const std::size_t mask = _slots.size() - 1;
+        std::size_t i = home(orderID);
+        while (used(_slots[i])) {
+            if (_slots[i].orderID == orderID) return {&_slots[i].handle, false};
+            i = (i + 1) & mask;
+        }
+        _slots[i] = Slot{orderID, handle, _epoch};
+        ++_hashed;
+        ++_size;
+        return {&_slots[i].handle, true};
+    }
+
+    inline OrderHandle OrderIndex::find(uint64_t orderID) const {
+        if (isDirect(orderID)) {
+            const DirectSlot& value = _direct[orderID - _directBase];
+            return value.epoch == _epoch ? value.handle : NO_HANDLE;
+        }
+        const std::size_t mask = _slots.size() - 1;
+        for (std::size_t i = home(orderID); used(_slots[i]); i = (i + 1) & mask) {
+            if (_slots[i].orderID == orderID) return _slots[i].handle;
+        }
+        return NO_HANDLE;
+    }
+
+    /// @comment Backward shift - each following slot of the same cluster is moved into the hole if the hole
+    ///          lies between its home slot and its current slot, so every ID stays reachable from its home slot
+    inline OrderHandle OrderIndex::erase(uint64_t orderID) {
+        if (isDirect(orderID)) {
+            DirectSlot& value = _direct[orderID - _directBase];
+            if (value.epoch != _epoch) return NO_HANDLE;
+            value.epoch = EMPTY_EPOCH;
+            --_size;
+            return value.handle;
+        }
+        const std::size_t mask = _slots.size() - 1;
+        std::size_t hole = home(orderID);
+        while (_slots[hole].orderID != orderID || !used(_slots[hole])) {
+            if (!used(_slots[hole])) return NO_HANDLE;
+            hole = (hole + 1) & mask;
+        }
+        const OrderHandle handle = _slots[hole].handle;
+        for (std::size_t i = (hole + 1) & mask; used(_slots[i]); i = (i + 1) & mask) {
+            if (((i - home(_slots[i].orderID)) & mask) >= ((i - hole) & mask)) {
+                _slots[hole] = _slots[i];
+                hole = i;
+            }
+        }
+        _slots[hole].epoch = EMPTY_EPOCH;
+        --_hashed;
+        --_size;
+        return handle;
+    }
+
+    /// @comment Slots are wiped only when epoch counter wraps - once per 2^32 - 1 clears
+    inline void OrderIndex::clear() {
+        if (++_epoch == EMPTY_EPOCH) {
+            for (Slot& slot : _slots) slot.epoch = EMPTY_EPOCH;
+            for (DirectSlot& value : _direct) value.epoch = EMPTY_EPOCH;
+            _epoch = EMPTY_EPOCH + 1;
+        }
+        _hashed = 0;
+        _size = 0;
+    }
+} // quant
+
+#endif //ORDER_BOOK_ORDERINDEX_H
@@ -0,0 +1,104 @@
+#ifndef ORDER_BOOK_ORDERPOOL_H
+#define ORDER_BOOK_ORDERPOOL_H
+
+/**
+ * @file    OrderPool.h
+ * @brief   Preallocated slab of Order records linked intrusively into FIFO queues of price levels
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Instrumentation.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Handle of Order (index inside OrderPool) - stays valid until the Order is released
+    using OrderHandle = uint32_t;
+    /// @brief Handle of price level (index inside PriceLevels) - stays valid until the level is erased
+    using LevelHandle = uint32_t;
+
+    /// @brief Value used as "no Order" / "no level" link
+    constexpr uint32_t NO_HANDLE = UINT32_MAX;
+
+    /// @struct Single Order record - member of doubly-linked FIFO queue of its price level
+    struct Order {
+        uint64_t id;
+        uint32_t price;
+        uint32_t qty;
+        LevelHandle level;
+        OrderHandle prev;
+        OrderHandle next;
+    };
+
+    /// @brief Slab of Orders with free list - adding and removing Orders doesn't touch malloc after warm-up
+    class OrderPool {
+    public:
+        /// @brief Default number of Orders allocated up front, slab grows beyond it on demand
+        static constexpr std::size_t DEFAULT_CAPACITY = 1 << 10;
+
+        explicit OrderPool(std::size_t capacity = DEFAULT_CAPACITY);
+        OrderPool(const OrderPool&) = default;
+        OrderPool& operator=(const OrderPool&) = default;
+        OrderPool(OrderPool&&) noexcept = default;
+        OrderPool& operator=(OrderPool&&) noexcept = default;
+        ~OrderPool() = default;
+
+        /// @brief Take free record from the slab, slab grows only when all preallocated records are used
+        OrderHandle allocate();
+
+        /**
+         * @brief Give record back to the slab
+         * @param handle record returned earlier by allocate
+         */
+        void release(OrderHandle handle);
+
+        /// @brief Access to the record, handle has to be allocated
+        Order& operator[](OrderHandle handle) { return _slab[handle]; }
+        const Order& operator[](OrderHandle handle) const { return _slab[handle]; }
+
+        /// @brief Returning number of Orders in use
+        std::size_t size() const { return _size; }
+
+        /// @brief Release all records at once in O(1) - slab is rewound, allocated memory is kept
+        void clear();
+
+        /**
+         * @brief Make place for given number of Orders up front, so slab doesn't grow during session
+         * @param capacity Number of Orders
+         */
+        void reserve(std::size_t capacity) { _slab.reserve(capacity); }
+
+    private:
+        /// @brief Storage of all records - handles are indexes, so growing it doesn't invalidate them
+        std::vector<Order> _slab;
+        /// @brief First free record, next ones are linked by Order::next
+        OrderHandle _freeList = NO_HANDLE;
+        /// @brief Number of records in use
+        std::size_t _size = 0;
+    };
+
+    /// @comment Released records are reused first, then untouched part of reserved slab
+    inline OrderHandle OrderPool::allocate() {
+        ++_size;
+        if (_freeList != NO_HANDLE) {
+            OrderHandle handle = _freeList;
+            _freeList = _slab[handle].next;
+            return handle;
+        }
+        if (_slab.size() == _slab.capacity()) ORDER_BOOK_COUNT(poolGrowth, 1);
+        _slab.emplace_back();
+        return static_cast<OrderHandle>(_slab.size() - 1);
+    }
+
+    inline void OrderPool::release(OrderHandle handle) {
+        _slab[handle].next = _freeList;
+        _freeList = handle;
+        --_size;
+    }
+} // quant
+
+#endif //ORDER_BOOK_ORDERPOOL_H
@@ -0,0 +1,58 @@
+#ifndef ORDER_BOOK_PATTERN_H
+#define ORDER_BOOK_PATTERN_H
+
+/**
+ * @file    Pattern.h
+ * @brief   Types describing single tick of input file and its result
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @enum To cover pure digits 1 and 2 and better understanding if we check bid or ask
+    enum Side : uint8_t { bid = '1', ask = '2' };
+
+    /// @enum To cover pure characters and better understanding which action is processed
+    enum Action : uint8_t { clear1 = 'Y', clear2 = 'F', add = 'A', modify = 'M', remove = 'D' };
+
+    /// @struct Pattern for correct reading input binary files and store data per tick
+    struct Pattern {
+        uint64_t SourceTime;
+        uint8_t Side;
+        uint8_t Action;
+        uint64_t OrderId;
+        uint32_t Price;
+        uint32_t Qty;
+        uint32_t B0 = UINT32_MAX;
+        uint32_t BQ0 = UINT32_MAX;
+        uint32_t BN0 = UINT32_MAX;
+        uint32_t A0 = UINT32_MAX;
+        uint32_t AQ0 = UINT32_MAX;
+        uint32_t AN0 = UINT32_MAX;
+    };
+
+    /// @brief The deepest level of Order Book which can be written to output (B0..B9 / A0..A9)
+    constexpr std::size_t MAX_DEPTH = 10;
+
+    /// @struct Aggregated price level of Order Book - UINT32_MAX means that there is no such level
+    struct Quote {
+        uint32_t Price = UINT32_MAX;
+        uint32_t Qty = UINT32_MAX;
+        uint32_t Orders = UINT32_MAX;
+    };
+
+    inline bool operator==(const Quote& lhs, const Quote& rhs) {
+        return lhs.Price == rhs.Price && lhs.Qty == rhs.Qty && lhs.Orders == rhs.Orders;
+    }
+
+    inline bool operator!=(const Quote& lhs, const Quote& rhs) { return !(lhs == rhs); }
+
+    /// @enum Bits telling which side of top of book (B0/BQ0/BN0, A0/AQ0/AN0) was changed by tick
+    enum TopChange : uint8_t { topUnchanged = 0, bidTopChanged = 1, askTopChanged = 2 };
+} // quant
+
+#endif //ORDER_BOOK_PATTERN_H
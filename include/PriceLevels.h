@@ -0,0 +1,249 @@
+#ifndef ORDER_BOOK_PRICELEVELS_H
+#define ORDER_BOOK_PRICELEVELS_H
+
+/**
+ * @file    PriceLevels.h
+ * @brief   Sorted flat ladder of unique price levels used by Order Book instead of heap
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "Instrumentation.h"
+#include "OrderPool.h"
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @struct One price level with running totals and FIFO queue (head -> tail) of all Orders stored on it
+    struct Level {
+        uint32_t price;
+        uint32_t shares = 0;
+        uint32_t orders = 0;
+        OrderHandle head = NO_HANDLE;
+        OrderHandle tail = NO_HANDLE;
+    };
+
+    /**
+     * @brief Compile-time description of side of Order Book
+     * @tparam side Side::bid or Side::ask
+     */
+    template<Side side>
+    struct SideTraits;
+
+    /// @comment Bids - the highest price is the best one
+    template<>
+    struct SideTraits<Side::bid> {
+        /// @brief Order of ladder - the greatest element is the best one
+        using compare = std::less<>;
+        /// @brief Price which is never better than any other - returned as best price of empty side
+        static constexpr uint32_t WORST_PRICE = 0;
+    };
+
+    /// @comment Asks - the lowest price is the best one
+    template<>
+    struct SideTraits<Side::ask> {
+        /// @brief Order of ladder - the greatest element is the best one
+        using compare = std::greater<>;
+        /// @brief Price which is never better than any other - returned as best price of empty side
+        static constexpr uint32_t WORST_PRICE = std::numeric_limits<uint32_t>::max();
+    };
+
+    /**
+     * @brief Unique prices kept sorted in one contiguous vector, the best price is always at the back
+     * @tparam side Side::bid or Side::ask - order of prices comes from SideTraits
+     * @comment Updates of the book happen mostly near the best price, so insert and erase move only few elements
+     *          and best price lookup is always O(1). Finding any level is binary search O(log n).
+     *          Levels itself are stored in separate slots, so LevelHandle kept by Orders is stable.
+     */
+    template<Side side>
+    class PriceLevels {
+    public:
+        /// @brief Order of prices in ladder
+        using compare = typename SideTraits<side>::compare;
+        /// @brief Default number of price levels allocated up front
+        static constexpr std::size_t DEFAULT_CAPACITY = 1 << 10;
+
+        PriceLevels() = default;
+        PriceLevels(const PriceLevels&) = default;
+        PriceLevels& operator=(const PriceLevels&) = default;
+        PriceLevels(PriceLevels&&) noexcept = default;
+        PriceLevels& operator=(PriceLevels&&) noexcept = default;
+        ~PriceLevels() = default;
+
+        /**
+         * @brief Add price if it is not stored yet
+         * @param price any value of type uint32_t (bid or ask)
+         * @return Handle of level with given price
+         */
+        LevelHandle push(uint32_t price);
+
+        /**
+         * @brief Find level with given price
+         * @param price any value of type uint32_t (bid or ask)
+         * @return Handle of level with given price or NO_HANDLE if there isn't one
+         */
+        LevelHandle find(uint32_t price) const;
+
+        /**
+         * @brief Remove any price level without rebuilding the ladder
+         * @param handle level returned earlier by push or find
+         */
+        void erase(LevelHandle handle);
+
+        /// @brief Access to the level, handle has to be valid
+        Level& operator[](LevelHandle handle) { return _slots[handle]; }
+        const Level& operator[](LevelHandle handle) const { return _slots[handle]; }
+
+        /// @brief Return the best level, ladder can't be empty
+        const Level& top() const { return _slots[_ladder.back().handle]; }
+
+        /**
+         * @brief Return level at given distance from the best one
+         * @param depth 0 for the best level, has to be lower than size()
+         */
+        const Level& atDepth(std::size_t depth) const { return _slots[_ladder[_ladder.size() - 1 - depth].handle]; }
+
+        /// @brief Remove the best price, ladder can't be empty
+        void pop();
+
+        /// @brief Checking if ladder has got any price
+        bool empty() const { return _ladder.empty(); }
+
+        /// @brief Returning number of stored price levels
+        std::size_t size() const { return _ladder.size(); }
+
+        /// @brief Remove all prices in O(1), allocated memory is kept
+        void clear();
+
+        /**
+         * @brief Make place for given number of price levels up front, so ladder doesn't grow during session
+         * @param capacity Number of price levels
+         */
+        void reserve(std::size_t capacity);
+
+    private:
+        /// @struct Element of ladder - price is copied here to keep binary search inside one vector
+        struct Rung {
+            uint32_t price;
+            LevelHandle handle;
+        };
+
+        /// @brief Sorted prices - from the worst price (front) to the best price (back)
+        std::vector<Rung> _ladder;
+        /**
+         * @brief First rung which is not better than given price
+         * @param price any value of type uint32_t (bid or ask)
+         */
+        typename std::vector<Rung>::iterator lowerBound(uint32_t price);
+        typename std::vector<Rung>::const_iterator lowerBound(uint32_t price) const;
+
+        /// @brief Storage of levels addressed by LevelHandle
+        std::vector<Level> _slots;
+        /// @brief Handles of erased levels ready to reuse
+        std::vector<LevelHandle> _freeSlots;
+    };
+
+    /**
+     * @brief Two types of price levels used as types to create Order Book for bid or ask
+     * @param bidLevels -> levels for bids where the highest value has the highest priority
+     * @param askLevels -> levels for asks where the lowest value has the highest priority
+     */
+    using bidLevels = PriceLevels<Side::bid>;
+    using askLevels = PriceLevels<Side::ask>;
+
+    /// @comment Definitions are in header, so whole hot path can be inlined into replay loop
+
+    /// @comment Compare rungs with price using given order of prices
+    template<Side side>
+    typename std::vector<typename PriceLevels<side>::Rung>::iterator PriceLevels<side>::lowerBound(uint32_t price) {
+        return std::lower_bound(_ladder.begin(), _ladder.end(), price,
+                                [](const Rung& rung, uint32_t value) { return compare()(rung.price, value); });
+    }
+
+    template<Side side>
+    typename std::vector<typename PriceLevels<side>::Rung>::const_iterator
+    PriceLevels<side>::lowerBound(uint32_t price) const {
+        return std::lower_bound(_ladder.begin(), _ladder.end(), price,
+                                [](const Rung& rung, uint32_t value) { return compare()(rung.price, value); });
+    }
+
+    /// @comment New best price is the most common case - it's just appended at the back
+    template<Side side>
+    LevelHandle PriceLevels<side>::push(uint32_t price) {
+        auto it = _ladder.end();
+        if (!_ladder.empty() && !compare()(_ladder.back().price, price)) {
+            if (_ladder.back().price == price) return _ladder.back().handle;
+            it = lowerBound(price);
+            if (it->price == price) return it->handle;
+        }
+
+        LevelHandle handle;
+        if (_freeSlots.empty()) {
+            handle = static_cast<LevelHandle>(_slots.size());
+            _slots.push_back(Level{price});
+        }
+        else {
+            handle = _freeSlots.back();
+            _freeSlots.pop_back();
+            _slots[handle] = Level{price};
+        }
+        ORDER_BOOK_COUNT(levelCreated, 1);
+        ORDER_BOOK_COUNT(ladderShift, _ladder.end() - it);
+        _ladder.insert(it, Rung{price, handle});
+        return handle;
+    }
+
+    template<Side side>
+    LevelHandle PriceLevels<side>::find(uint32_t price) const {
+        if (_ladder.empty()) return NO_HANDLE;
+        if (_ladder.back().price == price) return _ladder.back().handle;
+        auto it = lowerBound(price);
+        return (it == _ladder.end() || it->price != price) ? NO_HANDLE : it->handle;
+    }
+
+    template<Side side>
+    void PriceLevels<side>::erase(LevelHandle handle) {
+        uint32_t price = _slots[handle].price;
+        ORDER_BOOK_COUNT(levelDeleted, 1);
+        if (_ladder.back().price == price) {
+            _ladder.pop_back();
+        }
+        else {
+            auto it = lowerBound(price);
+            ORDER_BOOK_COUNT(ladderShift, _ladder.end() - it - 1);
+            _ladder.erase(it);
+        }
+        _freeSlots.push_back(handle);
+    }
+
+    template<Side side>
+    void PriceLevels<side>::pop() {
+        ORDER_BOOK_COUNT(levelDeleted, 1);
+        _freeSlots.push_back(_ladder.back().handle);
+        _ladder.pop_back();
+    }
+
+    template<Side side>
+    void PriceLevels<side>::reserve(std::size_t capacity) {
+        _ladder.reserve(capacity);
+        _slots.reserve(capacity);
+        _freeSlots.reserve(capacity);
+    }
+
+    template<Side side>
+    void PriceLevels<side>::clear() {
+        ORDER_BOOK_COUNT(levelDeleted, _ladder.size());
+        _ladder.clear();
+        _slots.clear();
+        _freeSlots.clear();
+    }
+} // quant
+
+#endif //ORDER_BOOK_PRICELEVELS_H
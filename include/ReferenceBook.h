@@ -0,0 +1,76 @@
+#ifndef ORDER_BOOK_REFERENCEBOOK_H
+#define ORDER_BOOK_REFERENCEBOOK_H
+
+/**
+ * @file    ReferenceBook.h
+ * @brief   Slow and simple Order Book used as oracle by validation - standard containers only, no optimizations
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /**
+     * @brief Both sides of Order Book with the same rules as runActions, written as plainly as possible
+     * @comment Each side has its own Orders (the same OrderId can stand on both sides). Add of existing Order
+     *          replaces it, modify of missing Order adds it, remove of missing Order is ignored, clear actions
+     *          remove everything. Ticks with unknown side change nothing.
+     */
+    class ReferenceBook {
+    public:
+        /**
+         * @brief Apply action of tick
+         * @param tick Struct with data per tick, result columns are not used
+         */
+        void apply(const Pattern& tick);
+
+        /**
+         * @brief Level at given distance from the best one
+         * @param side Side::bid or Side::ask
+         * @param depth 0 for the best level
+         * @return Level or empty Quote if side has fewer levels
+         */
+        Quote level(Side side, std::size_t depth) const;
+
+        /// @brief Returning number of price levels of side
+        std::size_t noLevels(Side side) const;
+
+        /// @brief Returning number of Orders of side
+        std::size_t noOrders(Side side) const;
+
+    private:
+        struct RefOrder {
+            uint32_t price;
+            uint32_t qty;
+        };
+
+        struct RefLevel {
+            uint32_t shares = 0;
+            uint32_t orders = 0;
+        };
+
+        /// @struct One side - levels sorted by price ascending, best bid is the last one and best ask the first one
+        struct RefSide {
+            std::map<uint32_t, RefLevel> levels;
+            std::unordered_map<uint64_t, RefOrder> orders;
+
+            void add(uint64_t orderID, uint32_t price, uint32_t qty);
+            void remove(uint64_t orderID);
+        };
+
+        RefSide& of(Side side) { return Side::bid == side ? _bid : _ask; }
+        const RefSide& of(Side side) const { return Side::bid == side ? _bid : _ask; }
+
+        RefSide _bid;
+        RefSide _ask;
+    };
+} // quant
+
+#endif //ORDER_BOOK_REFERENCEBOOK_H
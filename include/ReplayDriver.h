@@ -0,0 +1,96 @@
+#ifndef ORDER_BOOK_REPLAYDRIVER_H
+#define ORDER_BOOK_REPLAYDRIVER_H
+
+/**
+ * @file    ReplayDriver.h
+ * @brief   Replay of many input files at once - one independent Order Book per file on a pool of threads
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "MsgReader.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @struct Result of one input file processed by ReplayDriver
+    struct FileReport {
+        std::string input;
+        std::string output;
+        /// @brief Number of ticks and time of building Order Book
+        ReplayStats stats;
+        /// @brief Time of whole processing of file (read, build, write)
+        std::chrono::nanoseconds wallTime{0};
+        /// @brief Message of exception if file failed, empty otherwise
+        std::string error;
+    };
+
+    /// @brief Class running MsgReader for many files on fixed number of threads
+    class ReplayDriver {
+    public:
+        /**
+         * @param outputDir Directory of output files, created if needed
+         * @param options Settings used for each file - input, output and checkpoint directory are set per file
+         * @param stream Run each file as @fn MsgReader::stream instead of @fn MsgReader::read
+         */
+        ReplayDriver(std::string outputDir, ReaderOptions options, bool stream);
+
+        /**
+         * @brief Turn given files and directories into list of input files
+         * @param paths Files are taken as they are, from directories all regular *.raw files are taken
+         * @return Input files, files found in directory are sorted by name
+         */
+        static std::vector<std::string> collectInputs(const std::vector<std::string>& paths);
+
+        /**
+         * @brief Names of outputs and checkpoint directories of given inputs - name of input file without extension.
+         *        Inputs sharing a name are prefixed with name of their directory (ex. day1_ticks, day2_ticks).
+         *        Throws std::invalid_argument if names still collide, ex. the same file is given twice
+         * @param inputs Input files
+         * @return Names in order of inputs
+         */
+        static std::vector<std::string> namesOf(const std::vector<std::string>& inputs);
+
+        /**
+         * @brief Output file of given name - the name with extension of output format inside output directory
+         * @param name Name of input returned by @fn namesOf
+         */
+        std::string outputFor(const std::string& name) const;
+
+        /**
+         * @brief Process all files - each file is taken by the first free thread, failure of one file doesn't
+         *        stop others. Throws std::invalid_argument before start if outputs of files would collide
+         * @param inputs Input files
+         * @param threads Number of threads, not more than number of files is started
+         * @return Reports in order of inputs
+         */
+        std::vector<FileReport> run(const std::vector<std::string>& inputs, std::size_t threads) const;
+
+        /**
+         * @brief Print throughput of each file and aggregate throughput
+         * @param output Stream for report, ex. std::cout
+         * @param reports Result of @fn run
+         * @param wallTime Time of whole @fn run
+         */
+        static void report(std::ostream& output, const std::vector<FileReport>& reports,
+                           std::chrono::nanoseconds wallTime);
+
+    private:
+        /// @brief Process one file under given name, exceptions are stored in report
+        FileReport process(const std::string& input, const std::string& name) const;
+
+        /// @brief Directory of output files
+        std::string _outputDir;
+        /// @brief Settings used for each file
+        ReaderOptions _options;
+        /// @brief Flag if files are streamed
+        bool _stream;
+    };
+} // quant
+
+#endif //ORDER_BOOK_REPLAYDRIVER_H
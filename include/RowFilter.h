@@ -0,0 +1,131 @@
+#ifndef ORDER_BOOK_ROWFILTER_H
+#define ORDER_BOOK_ROWFILTER_H
+
+/**
+ * @file    RowFilter.h
+ * @brief   Choice of ticks written to output - all of them, only changes of top of book or conflated changes
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @enum Which ticks are written to output
+    enum class OutputFilter : uint8_t {
+        /// @brief Every tick - the same output as input
+        all,
+        /// @brief Only ticks which changed B0/BQ0/BN0 or A0/AQ0/AN0
+        changed,
+        /// @brief Changes of top of book, but at most one row per interval of SourceTime per side
+        conflated
+    };
+
+    /**
+     * @brief Filter run by writer on ticks in input order - decides which rows go to output
+     * @comment In conflated mode change of side which was written less than interval ago is held back. Later rows
+     *          carry the latest state of both sides, so held change is written with the first row allowed for all
+     *          changed sides - or by @fn finish. Time going back (next session) allows row at once.
+     */
+    class RowFilter {
+    public:
+        /**
+         * @param filter Which ticks are written
+         * @param interval Conflated only - minimal distance of SourceTime between rows changing the same side
+         * @param levelsPerRow Number of deeper levels written with each tick (2 * (depth - 1))
+         */
+        RowFilter(OutputFilter filter, uint64_t interval, std::size_t levelsPerRow)
+            : _filter(filter), _interval(interval), _heldLevels(levelsPerRow) {}
+
+        /**
+         * @brief Pass next tick, emit is called for rows which have to be written now
+         * @param tick Tick with result columns filled
+         * @param levels Deeper levels of tick, levelsPerRow elements
+         * @param changed TopChange bits returned by @fn runActions for the tick
+         * @param emit Called as emit(const Pattern&, const Quote*)
+         */
+        template<typename Emit>
+        void next(const Pattern& tick, const Quote* levels, uint8_t changed, Emit&& emit);
+
+        /// @brief Write change held back by conflation, called after the last tick
+        template<typename Emit>
+        void finish(Emit&& emit);
+
+        /// @brief Returning number of ticks passed to filter
+        std::size_t ticks() const { return _ticks; }
+
+        /// @brief Returning number of rows emitted
+        std::size_t rows() const { return _rows; }
+
+    private:
+        /// @brief Checking if side can be written at given SourceTime
+        bool due(std::size_t side, uint64_t time) const {
+            return !(_written & (1U << side)) || time < _lastTime[side] || time - _lastTime[side] >= _interval;
+        }
+
+        OutputFilter _filter;
+        /// @brief Minimal distance of SourceTime between rows changing the same side
+        uint64_t _interval;
+        /// @brief SourceTime of the last row which changed bid (0) and ask (1)
+        std::array<uint64_t, 2> _lastTime{};
+        /// @brief TopChange bits of sides written at least once
+        uint8_t _written = topUnchanged;
+        /// @brief TopChange bits of changes held back
+        uint8_t _pending = topUnchanged;
+        /// @brief The latest tick which changed top of book but wasn't written
+        Pattern _held{};
+        /// @brief Deeper levels of held tick
+        std::vector<Quote> _heldLevels;
+        std::size_t _ticks = 0;
+        std::size_t _rows = 0;
+    };
+
+    template<typename Emit>
+    void RowFilter::next(const Pattern& tick, const Quote* levels, uint8_t changed, Emit&& emit) {
+        ++_ticks;
+        if (OutputFilter::all == _filter || (OutputFilter::changed == _filter && changed != topUnchanged)) {
+            emit(tick, levels);
+            ++_rows;
+            return;
+        }
+        const uint8_t pending = _pending | changed;
+        if (OutputFilter::changed == _filter || pending == topUnchanged) return;
+
+        for (std::size_t side = 0; side < _lastTime.size(); ++side) {
+            if ((pending & (1U << side)) && !due(side, tick.SourceTime)) {
+                if (changed != topUnchanged) {
+                    _held = tick;
+                    std::copy(levels, levels + _heldLevels.size(), _heldLevels.begin());
+                }
+                _pending = pending;
+                return;
+            }
+        }
+        // Interval is counted from SourceTime of written row - held tick is older than the tick releasing it
+        const Pattern& row = changed != topUnchanged ? tick : _held;
+        emit(row, changed != topUnchanged ? levels : _heldLevels.data());
+        ++_rows;
+        for (std::size_t side = 0; side < _lastTime.size(); ++side) {
+            if (pending & (1U << side)) _lastTime[side] = row.SourceTime;
+        }
+        _written |= pending;
+        _pending = topUnchanged;
+    }
+
+    template<typename Emit>
+    void RowFilter::finish(Emit&& emit) {
+        if (_pending == topUnchanged) return;
+        emit(_held, _heldLevels.data());
+        ++_rows;
+        _pending = topUnchanged;
+    }
+} // quant
+
+#endif //ORDER_BOOK_ROWFILTER_H
@@ -0,0 +1,112 @@
+#ifndef ORDER_BOOK_SNAPSHOT_H
+#define ORDER_BOOK_SNAPSHOT_H
+
+/**
+ * @file    Snapshot.h
+ * @brief   Checkpoints of full state of both sides of Order Book - restart without replaying whole input file
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "Book.h"
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Magic number at the beginning of snapshot file - "QOBS" as read from file
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x53424F51;
+    /// @brief Version of layout of snapshot file
+    constexpr uint16_t SNAPSHOT_VERSION = 1;
+
+    /// @struct Place in input file where snapshot was taken - state of Order Book after given number of ticks
+    struct Checkpoint {
+        /// @brief Number of ticks processed before snapshot
+        uint64_t ticks;
+        /// @brief Offset in bytes of the first record which isn't included in snapshot
+        uint64_t offset;
+        /// @brief SourceTime of the last processed tick
+        uint64_t sourceTime;
+    };
+
+    /**
+     * @brief Write both sides of Order Book to snapshot file, file appears only when it's complete
+     * @param path Path to snapshot file
+     * @param book Both sides of Order Book
+     * @param checkpoint Place in input file of the snapshot
+     * @comment Layout, all fields little-endian:
+     *          header: magic u32, version u16, reserved u16, ticks u64, offset u64, sourceTime u64,
+     *                  number of bid levels u32, number of ask levels u32
+     *          then bid levels and ask levels from the best one: price u32, shares u32, orders u32,
+     *          followed by its Orders in FIFO order: OrderId u64, Qty u32
+     */
+    void saveSnapshot(const std::string& path, const Book& book, const Checkpoint& checkpoint);
+
+    /**
+     * @brief Replace state of Order Book with content of snapshot file, throws std::runtime_error if file is broken
+     * @param path Path to snapshot file
+     * @param book Both sides of Order Book - cleared before loading, its last written top is set to loaded one
+     * @return Place in input file where processing has to be continued
+     */
+    Checkpoint loadSnapshot(const std::string& path, Book& book);
+
+    /**
+     * @brief Name of snapshot file taken after given number of ticks
+     * @param directory Directory with snapshots
+     * @param ticks Number of ticks processed before snapshot
+     */
+    std::string snapshotPath(const std::string& directory, uint64_t ticks);
+
+    /**
+     * @brief Find the latest snapshot taken not later than given tick
+     * @param directory Directory with snapshots
+     * @param maxTicks The latest accepted number of processed ticks
+     * @return Path to snapshot file or nothing if there isn't one
+     */
+    std::optional<std::string> findSnapshot(const std::string& directory, uint64_t maxTicks = UINT64_MAX);
+
+    /// @brief Decides when snapshots are written during processing of input file
+    class Checkpointer {
+    public:
+        /**
+         * @param directory Directory for snapshots, created if needed
+         * @param every Snapshot after each given number of ticks, 0 turns it off
+         * @param onClear Snapshot after each clear action (clear1, clear2)
+         */
+        Checkpointer(std::string directory, std::size_t every, bool onClear);
+
+        /**
+         * @brief Called after each processed tick - writes snapshot if it's time for it
+         * @param book Both sides of Order Book after tick
+         * @param tick Processed tick
+         * @param ticks Number of processed ticks including this one (counted from the beginning of input file)
+         */
+        void after(const Book& book, const Pattern& tick, uint64_t ticks) {
+            if ((_every != 0 && ticks % _every == 0)
+                || (_onClear && (Action::clear1 == tick.Action || Action::clear2 == tick.Action))) {
+                write(book, tick, ticks);
+            }
+        }
+
+        /// @brief Number of written snapshots
+        std::size_t written() const { return _written; }
+
+    private:
+        void write(const Book& book, const Pattern& tick, uint64_t ticks);
+
+        /// @brief Directory for snapshots
+        std::string _directory;
+        /// @brief Number of ticks between snapshots, 0 if off
+        std::size_t _every;
+        /// @brief Flag if snapshot is written after clear actions
+        bool _onClear;
+        /// @brief Number of written snapshots
+        std::size_t _written = 0;
+    };
+} // quant
+
+#endif //ORDER_BOOK_SNAPSHOT_H
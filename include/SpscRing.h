@@ -0,0 +1,81 @@
+#ifndef ORDER_BOOK_SPSCRING_H
+#define ORDER_BOOK_SPSCRING_H
+
+/**
+ * @file    SpscRing.h
+ * @brief   Lock-free bounded queue for exactly one producer thread and one consumer thread
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Size of cache line - producer and consumer indexes are kept on separate lines
+    constexpr std::size_t CACHE_LINE = 64;
+
+    /**
+     * @brief Ring buffer where push is called only by producer and pop only by consumer
+     * @tparam T copyable type of element
+     * @tparam capacity number of elements, has to be power of two
+     */
+    template<typename T, std::size_t capacity>
+    class SpscRing {
+        static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "capacity has to be power of two");
+
+    public:
+        SpscRing() = default;
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+        ~SpscRing() = default;
+
+        /**
+         * @brief Producer side - put element at the end of queue
+         * @param value element to copy into queue
+         * @return false if queue is full
+         */
+        bool push(const T& value) {
+            std::size_t head = _head.load(std::memory_order_relaxed);
+            if (head - _tailCache == capacity) {
+                _tailCache = _tail.load(std::memory_order_acquire);
+                if (head - _tailCache == capacity) return false;
+            }
+            _buffer[head & (capacity - 1)] = value;
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Consumer side - take element from the beginning of queue
+         * @param value place to copy element to
+         * @return false if queue is empty
+         */
+        bool pop(T& value) {
+            std::size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _headCache) {
+                _headCache = _head.load(std::memory_order_acquire);
+                if (tail == _headCache) return false;
+            }
+            value = _buffer[tail & (capacity - 1)];
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        /// @brief Next position to write - written only by producer
+        alignas(CACHE_LINE) std::atomic<std::size_t> _head{0};
+        /// @brief Last seen value of _tail - used only by producer
+        std::size_t _tailCache = 0;
+        /// @brief Next position to read - written only by consumer
+        alignas(CACHE_LINE) std::atomic<std::size_t> _tail{0};
+        /// @brief Last seen value of _head - used only by consumer
+        std::size_t _headCache = 0;
+        /// @brief Elements of queue
+        alignas(CACHE_LINE) std::array<T, capacity> _buffer{};
+    };
+} // quant
+
+#endif //ORDER_BOOK_SPSCRING_H
@@ -0,0 +1,149 @@
+#ifndef ORDER_BOOK_TICKFILE_H
+#define ORDER_BOOK_TICKFILE_H
+
+/**
+ * @file    TickFile.h
+ * @brief   Memory-mapped input binary file - records are decoded in place, file is never loaded as a whole
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <arpa/inet.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <endian.h>
+#include <iterator>
+#include <string>
+
+#include "MappedFile.h"
+#include "Pattern.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Size of one packed big-endian record of input binary file
+    constexpr std::size_t RECORD_SIZE = 26;
+
+    /**
+     * @brief Decode one packed big-endian record into tick
+     * @param record Pointer to the first byte of record (no alignment is required)
+     * @param tick Struct to store data per tick
+     */
+    inline void decodeRecord(const unsigned char* record, Pattern& tick) {
+        std::memcpy(&tick.SourceTime, record, sizeof(tick.SourceTime));
+        tick.SourceTime = be64toh(tick.SourceTime);
+        tick.Side = record[8];
+        tick.Action = record[9];
+        std::memcpy(&tick.OrderId, record + 10, sizeof(tick.OrderId));
+        tick.OrderId = be64toh(tick.OrderId);
+        std::memcpy(&tick.Price, record + 18, sizeof(tick.Price));
+        tick.Price = ntohl(tick.Price);
+        std::memcpy(&tick.Qty, record + 22, sizeof(tick.Qty));
+        tick.Qty = ntohl(tick.Qty);
+    }
+
+    /**
+     * @brief Encode tick into packed big-endian record - reverse of @fn decodeRecord
+     * @param tick Struct with data per tick
+     * @param record Place for RECORD_SIZE bytes
+     */
+    inline void encodeRecord(const Pattern& tick, unsigned char* record) {
+        uint64_t sourceTime = htobe64(tick.SourceTime);
+        uint64_t orderId = htobe64(tick.OrderId);
+        uint32_t price = htonl(tick.Price);
+        uint32_t qty = htonl(tick.Qty);
+        std::memcpy(record, &sourceTime, sizeof(sourceTime));
+        record[8] = tick.Side;
+        record[9] = tick.Action;
+        std::memcpy(record + 10, &orderId, sizeof(orderId));
+        std::memcpy(record + 18, &price, sizeof(price));
+        std::memcpy(record + 22, &qty, sizeof(qty));
+    }
+
+    /// @brief Size of record of multi-instrument input - big-endian 32bit InstrumentId followed by standard record
+    constexpr std::size_t EXTENDED_RECORD_SIZE = sizeof(uint32_t) + RECORD_SIZE;
+
+    /**
+     * @brief InstrumentId of record of multi-instrument input - the rest of record isn't decoded
+     * @param record Pointer to the first byte of record (no alignment is required)
+     */
+    inline uint32_t instrumentOf(const unsigned char* record) {
+        uint32_t instrumentId;
+        std::memcpy(&instrumentId, record, sizeof(instrumentId));
+        return ntohl(instrumentId);
+    }
+
+    /**
+     * @brief Decode one record of multi-instrument input
+     * @param record Pointer to the first byte of record (no alignment is required)
+     * @param tick Struct to store data per tick
+     * @return InstrumentId of the record
+     */
+    inline uint32_t decodeExtendedRecord(const unsigned char* record, Pattern& tick) {
+        decodeRecord(record + sizeof(uint32_t), tick);
+        return instrumentOf(record);
+    }
+
+    /// @brief Read-only mapping of input binary file with iterator over decoded records
+    class TickFile {
+    public:
+        /// @brief Forward iterator decoding record on dereference - nothing is copied from mapping before
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Pattern;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Pattern;
+
+            explicit iterator(const unsigned char* record) : _record(record) {}
+
+            Pattern operator*() const {
+                Pattern tick;
+                decodeRecord(_record, tick);
+                return tick;
+            }
+            iterator& operator++() { _record += RECORD_SIZE; return *this; }
+            iterator operator++(int) { iterator it = *this; _record += RECORD_SIZE; return it; }
+            bool operator==(const iterator& other) const { return _record == other._record; }
+            bool operator!=(const iterator& other) const { return _record != other._record; }
+
+            /// @brief Raw bytes of current record
+            const unsigned char* data() const { return _record; }
+
+        private:
+            const unsigned char* _record;
+        };
+
+        /**
+         * @brief Map whole file, throws std::system_error if file can't be open or mapped
+         * @param path Path to input binary file
+         * @param sequential Advise kernel that file will be read once from the beginning (MADV_SEQUENTIAL)
+         */
+        explicit TickFile(const std::string& path, bool sequential = true) : _file(path, sequential) {}
+
+        /// @brief Returning number of complete records - trailing incomplete record is ignored
+        std::size_t size() const { return _file.size() / RECORD_SIZE; }
+
+        iterator begin() const { return iterator(_file.data()); }
+        iterator end() const { return at(size()); }
+
+        /**
+         * @brief Iterator to record with given index
+         * @param index Number of record counted from 0, can be equal to size()
+         */
+        iterator at(std::size_t index) const { return iterator(_file.data() + index * RECORD_SIZE); }
+
+        /**
+         * @brief Give back to kernel pages with records which won't be read again - keeps resident memory bounded
+         * @param records Number of records from the beginning of file which are already processed
+         */
+        void release(std::size_t records) { _file.release(records * RECORD_SIZE); }
+
+    private:
+        /// @brief Mapping of whole file
+        MappedFile _file;
+    };
+} // quant
+
+#endif //ORDER_BOOK_TICKFILE_H
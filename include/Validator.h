@@ -0,0 +1,70 @@
+#ifndef ORDER_BOOK_VALIDATOR_H
+#define ORDER_BOOK_VALIDATOR_H
+
+/**
+ * @file    Validator.h
+ * @brief   Validation of Order Book - replay checked tick by tick against ReferenceBook, output compared with
+ *          golden CSV and random sequences of actions (fuzzing)
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "MsgReader.h"
+
+/// @namespace "quant" for Quant Sky dedicated solution
+namespace quant {
+    /// @brief Number of preceding ticks or lines printed with the first divergence
+    constexpr std::size_t DIVERGENCE_CONTEXT = 5;
+
+    /**
+     * @brief Replay input file through Book (runActions) and ReferenceBook at once. After each tick result columns
+     *        and MAX_DEPTH levels of each side are compared. The first divergence is printed with preceding ticks
+     *        and both books
+     * @param inputFile Input binary file
+     * @param capacity Orders and price levels allocated for each side of Book
+     * @param report Stream for result, ex. std::cout
+     * @return True if both books agree on every tick
+     */
+    bool validateReplay(const std::string& inputFile, const BookCapacity& capacity, std::ostream& report);
+
+    /**
+     * @brief Compare output CSV file with golden CSV line by line (line endings CRLF and LF are equal). Golden file
+     *        can be shorter - only its lines are compared. The first different line is printed with names of
+     *        different columns and preceding lines
+     * @param outputFile CSV written by MsgReader
+     * @param goldenFile Expected CSV
+     * @param report Stream for result, ex. std::cout
+     * @return True if all lines of golden file are the same in output file
+     */
+    bool validateGolden(const std::string& outputFile, const std::string& goldenFile, std::ostream& report);
+
+    /**
+     * @brief Random add/modify/remove/clear sequences on small ranges of prices and IDs (collisions, modify and
+     *        remove of missing Orders, the same ID on both sides, IDs inside and outside direct range of index)
+     *        run through Book and ReferenceBook and compared after each action
+     * @param actions Number of random actions
+     * @param seed Seed of random generator - the same seed gives the same sequence
+     * @param report Stream for result, ex. std::cout
+     * @return True if both books agree after every action
+     */
+    bool fuzzBooks(std::size_t actions, uint64_t seed, std::ostream& report);
+
+    /**
+     * @brief All checks of validation mode - scripted price moves, replay against ReferenceBook, processing of input
+     *        file to CSV and comparison with golden CSV, optionally fuzzing
+     * @param options Settings of processing - input file is replayed and its CSV output (temporary file) is compared
+     * @param goldenFile Expected CSV
+     * @param fuzzActions Number of random actions, 0 turns fuzzing off
+     * @param seed Seed of fuzzing
+     * @return True if all checks passed
+     */
+    bool validate(const ReaderOptions& options, const std::string& goldenFile, std::size_t fuzzActions,
+                  uint64_t seed);
+} // quant
+
+#endif //ORDER_BOOK_VALIDATOR_H
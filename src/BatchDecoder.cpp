@@ -0,0 +1,142 @@
+/**
+ * @file    BatchDecoder.cpp
+ * @brief   Source code of decoding blocks of big-endian input records into structure of arrays
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include "BatchDecoder.h"
+#include "TickFile.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ORDER_BOOK_X86 1
+#endif
+
+namespace quant {
+    /// @comment Implementations decode rows first..count-1, records points to record of row 0
+
+    /// @comment Reference implementation - same decoding as @fn decodeRecord
+    static void decodeScalar(const unsigned char* records, std::size_t first, std::size_t count, TickColumns& columns) {
+        for (std::size_t i = first; i < count; ++i) {
+            Pattern tick;
+            decodeRecord(records + i * RECORD_SIZE, tick);
+            columns.SourceTime[i] = tick.SourceTime;
+            columns.Side[i] = tick.Side;
+            columns.Action[i] = tick.Action;
+            columns.OrderId[i] = tick.OrderId;
+            columns.Price[i] = tick.Price;
+            columns.Qty[i] = tick.Qty;
+        }
+    }
+
+#ifdef ORDER_BOOK_X86
+    /// @comment Every record is read by two 16-byte loads: bytes 0..15 (SourceTime, Side, Action) and
+    ///          bytes 10..25 (OrderId, Price, Qty), so nothing is read outside of the record.
+    ///          Shuffles reverse bytes of each field in place - big-endian to little-endian.
+    __attribute__((target("ssse3")))
+    static void decodeSsse3(const unsigned char* records, std::size_t first, std::size_t count, TickColumns& columns) {
+        const __m128i headMask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m128i tailMask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 11, 10, 9, 8, 15, 14, 13, 12);
+        for (std::size_t i = first; i < count; ++i) {
+            const unsigned char* record = records + i * RECORD_SIZE;
+            __m128i head = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(record)), headMask);
+            __m128i tail = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(record + 10)), tailMask);
+            columns.SourceTime[i] = static_cast<uint64_t>(_mm_cvtsi128_si64(head));
+            columns.Side[i] = record[8];
+            columns.Action[i] = record[9];
+            columns.OrderId[i] = static_cast<uint64_t>(_mm_cvtsi128_si64(tail));
+            columns.Price[i] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(tail, 8)));
+            columns.Qty[i] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(tail, 12)));
+        }
+    }
+
+    /// @comment 16 bytes from each pointer - the first one goes to lower lane
+    __attribute__((target("avx2")))
+    static __m256i load2(const unsigned char* lower, const unsigned char* upper) {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lower))),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(upper)), 1);
+    }
+
+    /// @comment Two records per 256-bit register (one per 128-bit lane), four records per step. After byte swap
+    ///          unpack and permute put the same field of four records next to each other, so every column gets
+    ///          one vector store per step. Rest of block is decoded by SSSE3 code.
+    __attribute__((target("avx2")))
+    static void decodeAvx2(const unsigned char* records, std::size_t first, std::size_t count, TickColumns& columns) {
+        const __m256i headMask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                  7, 6, 5, 4, 3, 2, 1, 0, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m256i tailMask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                  7, 6, 5, 4, 3, 2, 1, 0, 11, 10, 9, 8, 15, 14, 13, 12);
+        const __m256i priceQtyOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        std::size_t i = first;
+        for (; i + 4 <= count; i += 4) {
+            const unsigned char* r0 = records + i * RECORD_SIZE;
+            const unsigned char* r1 = r0 + RECORD_SIZE;
+            const unsigned char* r2 = r0 + 2 * RECORD_SIZE;
+            const unsigned char* r3 = r0 + 3 * RECORD_SIZE;
+            // lanes: [r0 | r1] and [r2 | r3]
+            __m256i head01 = _mm256_shuffle_epi8(load2(r0, r1), headMask);
+            __m256i head23 = _mm256_shuffle_epi8(load2(r2, r3), headMask);
+            __m256i tail01 = _mm256_shuffle_epi8(load2(r0 + 10, r1 + 10), tailMask);
+            __m256i tail23 = _mm256_shuffle_epi8(load2(r2 + 10, r3 + 10), tailMask);
+
+            // unpack gives [r0, r2, r1, r3] - permute restores order of records
+            __m256i sourceTime = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(head01, head23), _MM_SHUFFLE(3, 1, 2, 0));
+            __m256i orderId = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(tail01, tail23), _MM_SHUFFLE(3, 1, 2, 0));
+            // unpack gives [P0, P2, Q0, Q2 | P1, P3, Q1, Q3] - permute makes [P0..P3 | Q0..Q3]
+            __m256i priceQty = _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi32(tail01, tail23), priceQtyOrder);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&columns.SourceTime[i]), sourceTime);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&columns.OrderId[i]), orderId);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&columns.Price[i]), _mm256_castsi256_si128(priceQty));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&columns.Qty[i]), _mm256_extracti128_si256(priceQty, 1));
+            columns.Side[i] = r0[8];
+            columns.Side[i + 1] = r1[8];
+            columns.Side[i + 2] = r2[8];
+            columns.Side[i + 3] = r3[8];
+            columns.Action[i] = r0[9];
+            columns.Action[i + 1] = r1[9];
+            columns.Action[i + 2] = r2[9];
+            columns.Action[i + 3] = r3[9];
+        }
+        decodeSsse3(records, i, count, columns);
+    }
+#endif
+
+    const char* decoderName(DecoderKind kind) {
+        switch (kind) {
+            case DecoderKind::ssse3: return "ssse3";
+            case DecoderKind::avx2: return "avx2";
+            default: return "scalar";
+        }
+    }
+
+    bool decoderSupported(DecoderKind kind) {
+#ifdef ORDER_BOOK_X86
+        __builtin_cpu_init();
+        if (DecoderKind::avx2 == kind) return __builtin_cpu_supports("avx2");
+        if (DecoderKind::ssse3 == kind) return __builtin_cpu_supports("ssse3");
+#endif
+        return DecoderKind::scalar == kind;
+    }
+
+    DecoderKind activeDecoder() {
+        static const DecoderKind kind = decoderSupported(DecoderKind::avx2)    ? DecoderKind::avx2
+                                        : decoderSupported(DecoderKind::ssse3) ? DecoderKind::ssse3
+                                                                               : DecoderKind::scalar;
+        return kind;
+    }
+
+    void decodeColumns(DecoderKind kind, const unsigned char* records, std::size_t count, TickColumns& columns) {
+#ifdef ORDER_BOOK_X86
+        if (DecoderKind::avx2 == kind) return decodeAvx2(records, 0, count, columns);
+        if (DecoderKind::ssse3 == kind) return decodeSsse3(records, 0, count, columns);
+#endif
+        decodeScalar(records, 0, count, columns);
+    }
+
+    void decodeColumns(const unsigned char* records, std::size_t count, TickColumns& columns) {
+        decodeColumns(activeDecoder(), records, count, columns);
+    }
+} // quant
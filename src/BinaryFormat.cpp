@@ -0,0 +1,89 @@
+/**
+ * @file    BinaryFormat.cpp
+ * @brief   Source code of compact binary result file
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "BinaryFormat.h"
+
+namespace quant {
+    /// @comment Value is stored only if it exists, presence bit says if it was there
+    static uint32_t encodeOptional(uint32_t value, uint8_t bit, uint8_t& present) {
+        if (value == UINT32_MAX) return 0;
+        present |= bit;
+        return htole32(value);
+    }
+
+    static uint32_t decodeOptional(uint32_t value, uint8_t bit, uint8_t present) {
+        return (present & bit) ? le32toh(value) : UINT32_MAX;
+    }
+
+    void encodeRecord(const Pattern& tick, BinaryRecord& record) {
+        record = BinaryRecord{};
+        record.SourceTime = htole64(tick.SourceTime);
+        record.OrderId = htole64(tick.OrderId);
+        record.Price = htole32(tick.Price);
+        record.Qty = htole32(tick.Qty);
+        record.B0 = encodeOptional(tick.B0, Presence::hasB0, record.present);
+        record.BQ0 = encodeOptional(tick.BQ0, Presence::hasBQ0, record.present);
+        record.BN0 = encodeOptional(tick.BN0, Presence::hasBN0, record.present);
+        record.A0 = encodeOptional(tick.A0, Presence::hasA0, record.present);
+        record.AQ0 = encodeOptional(tick.AQ0, Presence::hasAQ0, record.present);
+        record.AN0 = encodeOptional(tick.AN0, Presence::hasAN0, record.present);
+        record.Side = tick.Side;
+        record.Action = tick.Action;
+    }
+
+    void decodeRecord(const BinaryRecord& record, Pattern& tick) {
+        tick.SourceTime = le64toh(record.SourceTime);
+        tick.OrderId = le64toh(record.OrderId);
+        tick.Price = le32toh(record.Price);
+        tick.Qty = le32toh(record.Qty);
+        tick.B0 = decodeOptional(record.B0, Presence::hasB0, record.present);
+        tick.BQ0 = decodeOptional(record.BQ0, Presence::hasBQ0, record.present);
+        tick.BN0 = decodeOptional(record.BN0, Presence::hasBN0, record.present);
+        tick.A0 = decodeOptional(record.A0, Presence::hasA0, record.present);
+        tick.AQ0 = decodeOptional(record.AQ0, Presence::hasAQ0, record.present);
+        tick.AN0 = decodeOptional(record.AN0, Presence::hasAN0, record.present);
+        tick.Side = record.Side;
+        tick.Action = record.Action;
+    }
+
+    /// @comment Existing level has always at least one Order, so zeros can't be mistaken for real level
+    void encodeQuote(const Quote& quote, BinaryQuote& binary) {
+        if (quote.Orders == UINT32_MAX) {
+            binary = BinaryQuote{0, 0, 0};
+            return;
+        }
+        binary = BinaryQuote{htole32(quote.Price), htole32(quote.Qty), htole32(quote.Orders)};
+    }
+
+    void decodeQuote(const BinaryQuote& binary, Quote& quote) {
+        if (binary.Orders == 0) {
+            quote = Quote{};
+            return;
+        }
+        quote = Quote{le32toh(binary.Price), le32toh(binary.Qty), le32toh(binary.Orders)};
+    }
+
+    /// @comment Number of records is taken from header - file cut during writing is read only up to complete records
+    BinaryFile::BinaryFile(const std::string& path) : _file(path) {
+        if (_file.size() < sizeof(BinaryHeader)) throw std::runtime_error(path + ": too short for binary result");
+        const auto* header = reinterpret_cast<const BinaryHeader*>(_file.data());
+        if (le32toh(header->magic) != BINARY_MAGIC) throw std::runtime_error(path + ": not a binary result");
+        std::size_t recordSize = le16toh(header->recordSize);
+        std::size_t quotesSize = recordSize - sizeof(BinaryRecord);
+        if (le16toh(header->version) != BINARY_VERSION || recordSize < sizeof(BinaryRecord)
+            || quotesSize % (2 * sizeof(BinaryQuote)) != 0 || quotesSize / (2 * sizeof(BinaryQuote)) >= MAX_DEPTH) {
+            throw std::runtime_error(path + ": unsupported version of binary result");
+        }
+        _depth = 1 + quotesSize / (2 * sizeof(BinaryQuote));
+        std::size_t available = (_file.size() - sizeof(BinaryHeader)) / recordSize;
+        _size = std::min<std::size_t>(le64toh(header->count), available);
+        _records = _file.data() + sizeof(BinaryHeader);
+    }
+} // quant
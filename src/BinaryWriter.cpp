@@ -0,0 +1,97 @@
+/**
+ * @file    BinaryWriter.cpp
+ * @brief   Source code of writer of compact binary result file
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cerrno>
+#include <cstddef>
+#include <endian.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+#include "BinaryWriter.h"
+
+namespace quant {
+    BinaryWriter::BinaryWriter(const std::string& path, bool keep)
+        : _buffer(new BinaryRecord[BUFFER_SIZE / sizeof(BinaryRecord)]) {
+        _fd = ::open(path.c_str(), keep ? O_RDWR | O_CREAT : O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_fd < 0) throw std::system_error(errno, std::generic_category(), path);
+    }
+
+    /// @comment Errors can't be reported from destructor - call flush before to get them
+    BinaryWriter::~BinaryWriter() {
+        try {
+            flush();
+        }
+        catch (const std::system_error&) {}
+        ::close(_fd);
+    }
+
+    void BinaryWriter::writeHeader(std::size_t depth) {
+        _recordSize = binaryRecordSize(depth);
+        BinaryHeader header{htole32(BINARY_MAGIC), htole16(BINARY_VERSION), htole16(static_cast<uint16_t>(_recordSize)), 0};
+        writeAt(&header, sizeof(header), 0);
+    }
+
+    /// @comment Records have fixed size, so the kept part is found from header only
+    void BinaryWriter::continueAfter(std::size_t rows, std::size_t depth) {
+        flush();
+        _recordSize = binaryRecordSize(depth);
+        BinaryHeader header{};
+        if (::pread(_fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+            || le32toh(header.magic) != BINARY_MAGIC || le16toh(header.version) != BINARY_VERSION
+            || le16toh(header.recordSize) != _recordSize) {
+            throw std::runtime_error("Output file to resume has other header than expected");
+        }
+        if (le64toh(header.count) < rows) {
+            throw std::runtime_error("Output file to resume has " + std::to_string(le64toh(header.count))
+                                     + " records, " + std::to_string(rows) + " are needed before snapshot");
+        }
+        _flushed = rows;
+        if (::ftruncate(_fd, static_cast<off_t>(sizeof(BinaryHeader) + rows * _recordSize)) < 0) {
+            throw std::system_error(errno, std::generic_category(), "BinaryWriter::continueAfter");
+        }
+        uint64_t count = htole64(_flushed);
+        writeAt(&count, sizeof(count), offsetof(BinaryHeader, count));
+    }
+
+    void BinaryWriter::write(const Pattern& tick, const Quote* levels, std::size_t depth) {
+        if ((_used + 1) * _recordSize > BUFFER_SIZE) flush();
+        auto* record = reinterpret_cast<unsigned char*>(_buffer.get()) + _used * _recordSize;
+        encodeRecord(tick, *reinterpret_cast<BinaryRecord*>(record));
+        auto* quotes = reinterpret_cast<BinaryQuote*>(record + sizeof(BinaryRecord));
+        for (std::size_t i = 0; i + 2 < 2 * depth; ++i) {
+            encodeQuote(levels[i], quotes[i]);
+        }
+        ++_used;
+    }
+
+    /// @comment Records go first, header after - reader never sees count bigger than number of written records
+    void BinaryWriter::flush() {
+        if (_used == 0) return;
+        writeAt(_buffer.get(), _used * _recordSize, sizeof(BinaryHeader) + _flushed * _recordSize);
+        _flushed += _used;
+        _used = 0;
+        uint64_t count = htole64(_flushed);
+        writeAt(&count, sizeof(count), offsetof(BinaryHeader, count));
+    }
+
+    /// @comment pwrite can store less than asked, so it's repeated until all bytes are in file
+    void BinaryWriter::writeAt(const void* data, std::size_t size, std::size_t offset) {
+        const auto* bytes = static_cast<const char*>(data);
+        std::size_t done = 0;
+        while (done < size) {
+            ssize_t written = ::pwrite(_fd, bytes + done, size - done, static_cast<off_t>(offset + done));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "BinaryWriter::flush");
+            }
+            done += static_cast<std::size_t>(written);
+        }
+    }
+} // quant
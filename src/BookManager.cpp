@@ -0,0 +1,112 @@
+/**
+ * @file    BookManager.cpp
+ * @brief   Source code of many instruments processed by fixed set of worker threads
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+#include "BookManager.h"
+#include "MsgReader.h"
+#include "SpscRing.h"
+
+namespace quant {
+    /// @brief Number of batches per worker - router waits when worker is this many batches behind
+    constexpr std::size_t WORKER_BATCHES = 8;
+    /// @brief Queue of batches between router and worker, nullptr marks end of input
+    using InstrumentRing = SpscRing<InstrumentBatch*, WORKER_BATCHES>;
+
+    /// @struct Everything owned by one worker - books are touched only by its thread
+    struct BookManager::Worker {
+        std::vector<InstrumentBatch> batches = std::vector<InstrumentBatch>(WORKER_BATCHES);
+        /// @brief Batches from router to worker
+        InstrumentRing work;
+        /// @brief Processed batches from worker back to router
+        InstrumentRing free;
+        /// @brief Batch filled by router right now
+        InstrumentBatch* pending = nullptr;
+        std::unordered_map<uint32_t, Book> books;
+        std::size_t ticks = 0;
+        std::thread thread;
+    };
+
+    /// @comment Busy waiting with yield - same as in streaming pipeline of MsgReader
+    static void pushBatch(InstrumentRing& ring, InstrumentBatch* batch) {
+        while (!ring.push(batch)) std::this_thread::yield();
+    }
+
+    static InstrumentBatch* popBatch(InstrumentRing& ring) {
+        InstrumentBatch* batch;
+        while (!ring.pop(batch)) std::this_thread::yield();
+        return batch;
+    }
+
+    BookManager::BookManager(std::size_t workers, const BookCapacity& capacity, Listener listener)
+        : _capacity(capacity), _listener(std::move(listener)) {
+        _workers.reserve(std::max<std::size_t>(workers, 1));
+        for (std::size_t index = 0; index < std::max<std::size_t>(workers, 1); ++index) {
+            auto worker = std::make_unique<Worker>();
+            for (std::size_t i = 1; i < WORKER_BATCHES; ++i) pushBatch(worker->free, &worker->batches[i]);
+            worker->pending = &worker->batches[0];
+
+            worker->thread = std::thread([this, index, &state = *worker] {
+                for (InstrumentBatch* batch = popBatch(state.work); batch; batch = popBatch(state.work)) {
+                    for (std::size_t i = 0; i < batch->size; ++i) {
+                        Pattern tick;
+                        decodeRecord(batch->records[i].data(), tick);
+                        runActions(state.books.try_emplace(batch->instrumentIds[i], _capacity).first->second, tick);
+                        if (_listener) _listener(index, batch->instrumentIds[i], tick);
+                    }
+                    state.ticks += batch->size;
+                    batch->size = 0;
+                    pushBatch(state.free, batch);
+                }
+            });
+            _workers.push_back(std::move(worker));
+        }
+    }
+
+    BookManager::~BookManager() {
+        finish();
+    }
+
+    void BookManager::route(const unsigned char* record) {
+        const uint32_t instrumentId = instrumentOf(record);
+        Worker& worker = *_workers[workerOf(instrumentId)];
+        InstrumentBatch& batch = *worker.pending;
+        batch.instrumentIds[batch.size] = instrumentId;
+        std::memcpy(batch.records[batch.size].data(), record + sizeof(instrumentId), RECORD_SIZE);
+        if (++batch.size == InstrumentBatch::CAPACITY) dispatch(worker);
+    }
+
+    void BookManager::finish() {
+        if (_finished) return;
+        _finished = true;
+        for (auto& worker : _workers) {
+            if (worker->pending->size > 0) dispatch(*worker);
+            pushBatch(worker->work, nullptr);
+        }
+        for (auto& worker : _workers) worker->thread.join();
+    }
+
+    /// @comment Fibonacci hashing spreads consecutive InstrumentIds evenly over workers
+    std::size_t BookManager::workerOf(uint32_t instrumentId) const {
+        uint64_t hash = static_cast<uint64_t>(instrumentId) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>((hash >> 32) % _workers.size());
+    }
+
+    std::vector<BookManager::WorkerStats> BookManager::stats() const {
+        std::vector<WorkerStats> result;
+        for (const auto& worker : _workers) result.push_back(WorkerStats{worker->ticks, worker->books.size()});
+        return result;
+    }
+
+    void BookManager::dispatch(Worker& worker) {
+        pushBatch(worker.work, worker.pending);
+        worker.pending = popBatch(worker.free);
+    }
+} // quant
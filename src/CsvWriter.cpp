@@ -0,0 +1,158 @@
+/**
+ * @file    CsvWriter.cpp
+ * @brief   Source code of allocation-free writer of result CSV file
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+#include "CsvWriter.h"
+
+namespace quant {
+    /// @brief Longest possible row: 3 x uint64_t, 8 x uint32_t, 2 characters, 11 separators, deeper levels and new line
+    constexpr std::size_t MAX_ROW_SIZE = 3 * 20 + 8 * 10 + 2 + 11 + (MAX_DEPTH - 1) * 6 * 11 + 1;
+
+    /// @brief Names of columns - same as written by @fn MsgReader::read, deeper levels and new line are added after
+    constexpr char HEADER[] = "SourceTime;Side;Action;OrderId;Price;Qty;B0;BQ0;BN0;A0;AQ0;AN0";
+
+    /// @comment Buffer always has place for MAX_ROW_SIZE, so to_chars can't fail
+    template<typename T>
+    static char* putNumber(char* out, T value) {
+        return std::to_chars(out, out + 20, value).ptr;
+    }
+
+    /// @comment UINT32_MAX means "no value" and is written as empty field
+    static char* putOptional(char* out, uint32_t value) {
+        return value != UINT32_MAX ? putNumber(out, value) : out;
+    }
+
+    CsvWriter::CsvWriter(const std::string& path, bool keep) : _buffer(new char[BUFFER_SIZE]) {
+        _fd = ::open(path.c_str(), keep ? O_RDWR | O_CREAT : O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_fd < 0) throw std::system_error(errno, std::generic_category(), path);
+    }
+
+    /// @comment Errors can't be reported from destructor - call flush before to get them
+    CsvWriter::~CsvWriter() {
+        try {
+            flush();
+        }
+        catch (const std::system_error&) {}
+        ::close(_fd);
+    }
+
+    void CsvWriter::writeHeader(std::size_t depth) {
+        if (_used + MAX_ROW_SIZE > BUFFER_SIZE) flush();
+        char* out = _buffer.get() + _used;
+        std::memcpy(out, HEADER, sizeof(HEADER) - 1);
+        out += sizeof(HEADER) - 1;
+        for (std::size_t level = 1; level < depth; ++level) {
+            for (const char* column : {";B", ";BQ", ";BN", ";A", ";AQ", ";AN"}) {
+                std::size_t length = std::strlen(column);
+                std::memcpy(out, column, length);
+                out = putNumber(out + length, level);
+            }
+        }
+        *out++ = '\n';
+        _used = static_cast<std::size_t>(out - _buffer.get());
+    }
+
+    /// @comment Expected header is formatted by writeHeader into empty buffer, then file is read in BUFFER_SIZE parts
+    ///          after it until given number of new lines is found
+    void CsvWriter::continueAfter(std::size_t rows, std::size_t depth) {
+        flush();
+        writeHeader(depth);
+        const std::string header(_buffer.get(), _used);
+        _used = 0;
+
+        std::string start(header.size(), '\0');
+        if (::pread(_fd, start.data(), start.size(), 0) != static_cast<ssize_t>(start.size()) || start != header) {
+            throw std::runtime_error("Output file to resume has other header than expected");
+        }
+        // Offset of the first row which isn't checked yet - incomplete row at the end of part is read again
+        std::size_t offset = header.size();
+        std::size_t found = 0;
+        while (found < rows) {
+            const ssize_t bytes = ::pread(_fd, _buffer.get(), BUFFER_SIZE, static_cast<off_t>(offset));
+            if (bytes < 0) throw std::system_error(errno, std::generic_category(), "CsvWriter::continueAfter");
+            const char* end = _buffer.get() + bytes;
+            const char* line = _buffer.get();
+            for (const char* newLine; found < rows && (newLine = static_cast<const char*>(
+                     std::memchr(line, '\n', static_cast<std::size_t>(end - line)))) != nullptr; ++found) {
+                line = newLine + 1;
+            }
+            if (line == _buffer.get()) {
+                throw std::runtime_error("Output file to resume has " + std::to_string(found) + " rows, "
+                                         + std::to_string(rows) + " are needed before snapshot");
+            }
+            offset += static_cast<std::size_t>(line - _buffer.get());
+        }
+        if (::ftruncate(_fd, static_cast<off_t>(offset)) < 0 || ::lseek(_fd, static_cast<off_t>(offset), SEEK_SET) < 0) {
+            throw std::system_error(errno, std::generic_category(), "CsvWriter::continueAfter");
+        }
+        _flushed = offset;
+    }
+
+    void CsvWriter::write(const Pattern& tick, const Quote* levels, std::size_t depth) {
+        if (_used + MAX_ROW_SIZE > BUFFER_SIZE) flush();
+        char* out = _buffer.get() + _used;
+        out = putNumber(out, tick.SourceTime);
+        *out++ = ';';
+        if (Side::ask == tick.Side || Side::bid == tick.Side) *out++ = static_cast<char>(tick.Side);
+        *out++ = ';';
+        *out++ = static_cast<char>(tick.Action);
+        *out++ = ';';
+        out = putNumber(out, tick.OrderId);
+        *out++ = ';';
+        out = putNumber(out, tick.Price);
+        *out++ = ';';
+        out = putNumber(out, tick.Qty);
+        *out++ = ';';
+        out = putOptional(out, tick.B0);
+        *out++ = ';';
+        out = putOptional(out, tick.BQ0);
+        *out++ = ';';
+        out = putOptional(out, tick.BN0);
+        *out++ = ';';
+        out = putOptional(out, tick.A0);
+        *out++ = ';';
+        out = putOptional(out, tick.AQ0);
+        *out++ = ';';
+        out = putOptional(out, tick.AN0);
+        for (std::size_t level = 0; level + 1 < depth; ++level) {
+            for (const Quote& quote : {levels[level], levels[depth - 1 + level]}) {
+                *out++ = ';';
+                out = putOptional(out, quote.Price);
+                *out++ = ';';
+                out = putOptional(out, quote.Qty);
+                *out++ = ';';
+                out = putOptional(out, quote.Orders);
+            }
+        }
+        *out++ = '\n';
+        _used = static_cast<std::size_t>(out - _buffer.get());
+    }
+
+    /// @comment write can store less than asked, so it's repeated until whole buffer is in file
+    void CsvWriter::flush() {
+        std::size_t offset = 0;
+        while (offset < _used) {
+            ssize_t written = ::write(_fd, _buffer.get() + offset, _used - offset);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "CsvWriter::flush");
+            }
+            offset += static_cast<std::size_t>(written);
+        }
+        _flushed += _used;
+        _used = 0;
+    }
+} // quant
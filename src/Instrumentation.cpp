@@ -0,0 +1,117 @@
+/**
+ * @file    Instrumentation.cpp
+ * @brief   Source code of latency histograms and counters of internal events
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+
+#include "Instrumentation.h"
+
+namespace quant {
+    /// @comment Values below 2 * SUB_BUCKETS have own buckets, above that bucket keeps SUB_BITS + 1 top bits of value
+    std::size_t LatencyHistogram::bucketOf(uint64_t value) {
+        if (value < 2 * SUB_BUCKETS) return static_cast<std::size_t>(value);
+        unsigned shift = 63 - static_cast<unsigned>(__builtin_clzll(value)) - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<std::size_t>(value >> shift) - SUB_BUCKETS;
+    }
+
+    uint64_t LatencyHistogram::highestOf(std::size_t bucket) {
+        if (bucket < 2 * SUB_BUCKETS) return bucket;
+        std::size_t shift = bucket / SUB_BUCKETS - 1;
+        uint64_t sub = bucket % SUB_BUCKETS + SUB_BUCKETS;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    void LatencyHistogram::record(uint64_t value) {
+        ++_buckets[bucketOf(value)];
+        ++_count;
+        _sum += value;
+        _max = std::max(_max, value);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < BUCKETS; ++i) _buckets[i] += other._buckets[i];
+        _count += other._count;
+        _sum += other._sum;
+        _max = std::max(_max, other._max);
+    }
+
+    uint64_t LatencyHistogram::percentile(double quantile) const {
+        if (_count == 0) return 0;
+        auto rank = static_cast<uint64_t>(quantile * static_cast<double>(_count));
+        rank = std::clamp<uint64_t>(rank, 1, _count);
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            seen += _buckets[i];
+            if (seen >= rank) return std::min(highestOf(i), _max);
+        }
+        return _max;
+    }
+
+    namespace instrumentation {
+        /// @comment Stats are owned by registry, so numbers of finished threads (ex. BookManager workers) stay
+        namespace {
+            std::mutex registryMutex;
+            std::deque<Stats> registry;
+        } // namespace
+
+        Stats& local() {
+            thread_local Stats* stats = [] {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                return &registry.emplace_back();
+            }();
+            return *stats;
+        }
+
+        /// @comment Clear actions don't belong to any side - they are kept as bid
+        void record(const Pattern& tick, uint64_t nanoseconds) {
+            auto action = static_cast<std::size_t>(std::find(ACTIONS.begin(), ACTIONS.end(), tick.Action) - ACTIONS.begin());
+            if (action == ACTIONS.size()) return;
+            std::size_t side = (action >= 2 && Side::ask == tick.Side) ? 1 : 0;
+            local().latency[action * 2 + side].record(nanoseconds);
+        }
+
+        Stats collect() {
+            Stats result;
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (const Stats& stats : registry) {
+                for (std::size_t i = 0; i < result.latency.size(); ++i) result.latency[i].merge(stats.latency[i]);
+                for (std::size_t i = 0; i < result.events.size(); ++i) result.events[i] += stats.events[i];
+            }
+            return result;
+        }
+
+        void report(std::ostream& output) {
+            static constexpr const char* SIDES[] = {"bid", "ask"};
+            static constexpr const char* EVENTS[] = {"levels created", "levels deleted", "ladder shifts",
+                                                     "pool growths", "index rehashes"};
+            Stats stats = collect();
+            output << "Latency per action [ns]:\n"
+                   << "action side      count      mean       p50       p99     p99.9       max\n";
+            for (std::size_t action = 0; action < ACTIONS.size(); ++action) {
+                for (std::size_t side = 0; side < 2; ++side) {
+                    const LatencyHistogram& histogram = stats.latency[action * 2 + side];
+                    if (histogram.count() == 0) continue;
+                    output << std::setw(6) << static_cast<char>(ACTIONS[action])
+                           << std::setw(5) << (action < 2 ? "-" : SIDES[side])
+                           << std::setw(11) << histogram.count()
+                           << std::setw(10) << std::fixed << std::setprecision(1) << histogram.mean()
+                           << std::setw(10) << histogram.percentile(0.5)
+                           << std::setw(10) << histogram.percentile(0.99)
+                           << std::setw(10) << histogram.percentile(0.999)
+                           << std::setw(10) << histogram.max() << '\n';
+                }
+            }
+            output << "Events:\n";
+            for (std::size_t event = 0; event < stats.events.size(); ++event) {
+                output << "  " << EVENTS[event] << ": " << stats.events[event] << '\n';
+            }
+            output.flush();
+        }
+    } // instrumentation
+} // quant
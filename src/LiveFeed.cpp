@@ -0,0 +1,292 @@
+/**
+ * @file    LiveFeed.cpp
+ * @brief   Source code of receiving and sending records of live feed
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+#include "LiveFeed.h"
+#include "TickFile.h"
+
+namespace quant {
+    /// @brief Requested size of kernel receive buffer of UDP socket and of pipe - kernel can give less
+    constexpr int KERNEL_BUFFER_SIZE = 1 << 22;
+
+    FeedAddress parseFeed(const std::string& address) {
+        FeedAddress feed;
+        if (address == "-" || address == "stdin") return feed;
+        if (address.rfind("fifo:", 0) == 0 && address.size() > 5) {
+            feed.path = address.substr(5);
+            return feed;
+        }
+        if (address.rfind("unix:", 0) == 0 && address.size() > 5) {
+            feed.kind = FeedKind::unixSocket;
+            feed.path = address.substr(5);
+            if (feed.path.size() < sizeof(sockaddr_un::sun_path)) return feed;
+        }
+        else if (address.rfind("udp:", 0) == 0) {
+            feed.kind = FeedKind::udp;
+            const std::size_t colon = address.rfind(':');
+            feed.host = address.substr(4, colon - 4);
+            const unsigned long port = std::strtoul(address.c_str() + colon + 1, nullptr, 10);
+            in_addr host{};
+            if (colon > 4 && port > 0 && port <= UINT16_MAX && ::inet_pton(AF_INET, feed.host.c_str(), &host) == 1) {
+                feed.port = static_cast<uint16_t>(port);
+                return feed;
+            }
+        }
+        throw std::invalid_argument("Invalid feed address: " + address);
+    }
+
+    /// @brief Socket address of UNIX socket feed
+    static sockaddr_un unixAddress(const FeedAddress& address) {
+        sockaddr_un socketAddress{};
+        socketAddress.sun_family = AF_UNIX;
+        std::memcpy(socketAddress.sun_path, address.path.c_str(), address.path.size());
+        return socketAddress;
+    }
+
+    /// @brief Socket address of UDP feed
+    static sockaddr_in udpAddress(const FeedAddress& address) {
+        sockaddr_in socketAddress{};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons(address.port);
+        ::inet_pton(AF_INET, address.host.c_str(), &socketAddress.sin_addr);
+        return socketAddress;
+    }
+
+    static bool isMulticast(const sockaddr_in& address) {
+        return IN_MULTICAST(ntohl(address.sin_addr.s_addr));
+    }
+
+    /// @comment Descriptor is closed before exception is thrown, so constructors don't leak it
+    [[noreturn]] static void fail(int fd, const std::string& what) {
+        const int error = errno;
+        if (fd >= 0) ::close(fd);
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    FeedSource::FeedSource(const FeedAddress& address) : _address(address) {
+        switch (_address.kind) {
+            case FeedKind::unixSocket: {
+                _listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+                if (_listenFd < 0) fail(-1, _address.path);
+                const sockaddr_un socketAddress = unixAddress(_address);
+                ::unlink(_address.path.c_str());        // Socket left by previous run
+                if (::bind(_listenFd, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) < 0 ||
+                    ::listen(_listenFd, 1) < 0) {
+                    fail(_listenFd, _address.path);
+                }
+                _buffer.resize(RECORD_SIZE + READ_SIZE);
+                break;
+            }
+            case FeedKind::udp: {
+                _fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+                if (_fd < 0) fail(-1, _address.host);
+                sockaddr_in socketAddress = udpAddress(_address);
+                const int enable = 1;
+                ::setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+                ::setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &KERNEL_BUFFER_SIZE, sizeof(KERNEL_BUFFER_SIZE));
+                const bool multicast = isMulticast(socketAddress);
+                ip_mreq membership{};
+                if (multicast) {
+                    // Group is joined on loopback interface - feed is sent by local process
+                    membership.imr_multiaddr = socketAddress.sin_addr;
+                    membership.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+                    socketAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+                }
+                if (::bind(_fd, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) < 0 ||
+                    (multicast && ::setsockopt(_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0)) {
+                    fail(_fd, _address.host + ':' + std::to_string(_address.port));
+                }
+                _buffer.resize(DATAGRAMS * MAX_DATAGRAM);
+                break;
+            }
+            case FeedKind::pipe:
+                if (_address.path.empty()) _fd = STDIN_FILENO;
+                else if ((_fd = ::open(_address.path.c_str(), O_RDONLY)) < 0) fail(-1, _address.path);
+                ::fcntl(_fd, F_SETPIPE_SZ, KERNEL_BUFFER_SIZE);  // Fails harmlessly for regular files
+                _buffer.resize(RECORD_SIZE + READ_SIZE);
+                break;
+        }
+    }
+
+    FeedSource::~FeedSource() {
+        if (_fd >= 0 && _fd != STDIN_FILENO) ::close(_fd);
+        if (_listenFd >= 0) ::close(_listenFd);
+        if (FeedKind::unixSocket == _address.kind) ::unlink(_address.path.c_str());
+    }
+
+    bool FeedSource::accept() {
+        while ((_fd = ::accept(_listenFd, nullptr, nullptr)) < 0) {
+            if (errno == EINTR) return false;
+            if (errno != ECONNABORTED) fail(-1, _address.path);
+        }
+        ::close(_listenFd);
+        _listenFd = -1;
+        return true;
+    }
+
+    std::size_t FeedSource::receive(const unsigned char*& records) {
+        if (_ended) return 0;
+        if (FeedKind::unixSocket == _address.kind && _fd < 0 && !accept()) {
+            _ended = true;
+            return 0;
+        }
+        return FeedKind::udp == _address.kind ? receiveDatagrams(records) : receiveStream(records);
+    }
+
+    /// @comment Each read goes right after incomplete record left by the previous one, so records are contiguous
+    std::size_t FeedSource::receiveStream(const unsigned char*& records) {
+        std::memmove(_buffer.data(), _buffer.data() + _partialOffset, _partialSize);
+        std::size_t size = _partialSize;
+        while (size < RECORD_SIZE) {
+            const ssize_t bytes = ::read(_fd, _buffer.data() + size, _buffer.size() - size);
+            if (bytes < 0 && errno != EINTR) fail(-1, _address.path.empty() ? "stdin" : _address.path);
+            if (bytes <= 0) {
+                // End of stream or interrupted by signal - incomplete record will never be completed
+                _stats.dropped += size;
+                _ended = true;
+                return 0;
+            }
+            ++_stats.reads;
+            _stats.bytes += static_cast<uint64_t>(bytes);
+            size += static_cast<std::size_t>(bytes);
+        }
+        const std::size_t count = size / RECORD_SIZE;
+        _partialOffset = count * RECORD_SIZE;
+        _partialSize = size - _partialOffset;
+        records = _buffer.data();
+        return count;
+    }
+
+    /// @comment Datagrams are received into separate slots and then moved one after another
+    std::size_t FeedSource::receiveDatagrams(const unsigned char*& records) {
+        std::array<iovec, DATAGRAMS> vectors{};
+        std::array<mmsghdr, DATAGRAMS> messages{};
+        for (std::size_t i = 0; i < DATAGRAMS; ++i) {
+            vectors[i].iov_base = _buffer.data() + i * MAX_DATAGRAM;
+            vectors[i].iov_len = MAX_DATAGRAM;
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        std::size_t size = 0;
+        while (size == 0 && !_ended) {
+            const int received = ::recvmmsg(_fd, messages.data(), DATAGRAMS, MSG_WAITFORONE, nullptr);
+            if (received < 0 && errno != EINTR) fail(-1, _address.host + ':' + std::to_string(_address.port));
+            if (received < 0) {
+                _ended = true;
+                break;
+            }
+            ++_stats.reads;
+            for (int i = 0; i < received && !_ended; ++i) {
+                const std::size_t bytes = messages[i].msg_len;
+                if (bytes == 0) {
+                    _ended = true;      // End of feed
+                    break;
+                }
+                const std::size_t whole = bytes - bytes % RECORD_SIZE;
+                _stats.bytes += bytes;
+                _stats.dropped += bytes - whole;
+                std::memmove(_buffer.data() + size, _buffer.data() + i * MAX_DATAGRAM, whole);
+                size += whole;
+            }
+        }
+        records = _buffer.data();
+        return size / RECORD_SIZE;
+    }
+
+    FeedSink::FeedSink(const FeedAddress& address, unsigned connectTimeoutMs) : _address(address) {
+        switch (_address.kind) {
+            case FeedKind::unixSocket: {
+                const sockaddr_un socketAddress = unixAddress(_address);
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connectTimeoutMs);
+                while (true) {
+                    _fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+                    if (_fd < 0) fail(-1, _address.path);
+                    if (::connect(_fd, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) == 0) {
+                        break;
+                    }
+                    // FeedSource may not be listening yet
+                    if ((errno != ENOENT && errno != ECONNREFUSED) || std::chrono::steady_clock::now() > deadline) {
+                        fail(_fd, _address.path);
+                    }
+                    ::close(_fd);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                break;
+            }
+            case FeedKind::udp: {
+                _fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+                if (_fd < 0) fail(-1, _address.host);
+                const sockaddr_in socketAddress = udpAddress(_address);
+                if (isMulticast(socketAddress)) {
+                    in_addr loopback{};
+                    loopback.s_addr = htonl(INADDR_LOOPBACK);
+                    const unsigned char enable = 1;
+                    ::setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback));
+                    ::setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &enable, sizeof(enable));
+                }
+                if (::connect(_fd, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) < 0) {
+                    fail(_fd, _address.host + ':' + std::to_string(_address.port));
+                }
+                break;
+            }
+            case FeedKind::pipe:
+                if (_address.path.empty()) _fd = STDOUT_FILENO;
+                else if ((_fd = ::open(_address.path.c_str(), O_WRONLY)) < 0) fail(-1, _address.path);
+                break;
+        }
+    }
+
+    FeedSink::~FeedSink() {
+        if (_fd >= 0 && _fd != STDOUT_FILENO) ::close(_fd);
+    }
+
+    void FeedSink::send(const unsigned char* records, std::size_t count) {
+        if (FeedKind::udp == _address.kind) {
+            for (std::size_t first = 0; first < count; first += RECORDS_PER_DATAGRAM) {
+                const std::size_t datagramRecords = std::min(RECORDS_PER_DATAGRAM, count - first);
+                while (::send(_fd, records + first * RECORD_SIZE, datagramRecords * RECORD_SIZE, 0) < 0) {
+                    // Full socket buffer - datagram is sent again instead of being lost on sender side
+                    if (errno != EINTR && errno != ENOBUFS && errno != EAGAIN) fail(-1, _address.host);
+                }
+            }
+            return;
+        }
+        // Stream transports take bytes - write can accept only part of them
+        std::size_t size = count * RECORD_SIZE;
+        while (size > 0) {
+            const ssize_t bytes = FeedKind::unixSocket == _address.kind ? ::send(_fd, records, size, MSG_NOSIGNAL)
+                                                                       : ::write(_fd, records, size);
+            if (bytes < 0) {
+                if (errno == EINTR) continue;
+                fail(-1, _address.path.empty() ? "stdout" : _address.path);
+            }
+            records += bytes;
+            size -= static_cast<std::size_t>(bytes);
+        }
+    }
+
+    void FeedSink::close() {
+        if (_fd < 0) return;
+        if (FeedKind::udp == _address.kind) ::send(_fd, nullptr, 0, 0);
+        ::close(_fd);
+        _fd = -1;
+    }
+} // quant
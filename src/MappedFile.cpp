@@ -0,0 +1,79 @@
+/**
+ * @file    MappedFile.cpp
+ * @brief   Source code of read-only memory mapping of whole file
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+#include "MappedFile.h"
+
+namespace quant {
+    MappedFile::MappedFile(const std::string& path, bool sequential) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), path);
+
+        struct stat status{};
+        if (::fstat(fd, &status) < 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+        _size = static_cast<std::size_t>(status.st_size);
+
+        // Empty file can't be mapped - it's just file without content
+        if (_size > 0) {
+            void* mapping = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), path);
+            }
+            _data = static_cast<const unsigned char*>(mapping);
+            if (sequential) ::madvise(mapping, _size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);    // Mapping stays valid after closing descriptor
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : _data(std::exchange(other._data, nullptr)),
+          _size(std::exchange(other._size, 0)),
+          _released(std::exchange(other._released, 0)) {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _released = std::exchange(other._released, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    /// @comment Only whole pages are given back, so data crossing page boundary stays readable
+    void MappedFile::release(std::size_t bytes) {
+        static const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        bytes = bytes / pageSize * pageSize;
+        if (bytes <= _released || bytes > _size) return;
+        ::madvise(const_cast<unsigned char*>(_data) + _released, bytes - _released, MADV_DONTNEED);
+        _released = bytes;
+    }
+
+    void MappedFile::close() {
+        if (_data != nullptr) ::munmap(const_cast<unsigned char*>(_data), _size);
+        _data = nullptr;
+        _size = 0;
+        _released = 0;
+    }
+} // quant
@@ -5,14 +5,35 @@
  * @mail    m.piwowar2@gmail.com
  */
 
+#include <algorithm>
 #include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
 #include <chrono>
-#include <deque>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
 
+#include "BinaryWriter.h"
+#include "BookManager.h"
+#include "CsvWriter.h"
+#include "LiveFeed.h"
 #include "MsgReader.h"
+#include "Snapshot.h"
+#include "SpscRing.h"
+#include "TickFile.h"
 
 namespace quant {
     void readBinaryFile(std::ifstream& inputFile, Pattern& tick) {
@@ -28,78 +49,6 @@ namespace quant {
         tick.Qty = ntohl(tick.Qty);
     }
 
-    template<typename bidHeap, typename askHeap>
-    void processClear(OrderBook<bidHeap>& bidOrderBook, OrderBook<askHeap>& askOrderBook) {
-        bidOrderBook.clearAll();
-        askOrderBook.clearAll();
-    }
-
-    template<typename heap>
-    void processAdd(OrderBook<heap>& orderBook, Pattern& tick) {
-        orderBook.addOrder(tick.OrderId, tick.Qty);
-        orderBook.addOrderToGroup(tick.Price, tick.OrderId);    // Adding unique Price
-    }
-
-    /// @comment From delivered instruction and implemented logic - modify process is exactly same like @fn processAdd
-    template<typename heap>
-    void processModify(OrderBook<heap>& orderBook, Pattern& tick) {
-        orderBook.addOrder(tick.OrderId, tick.Qty);
-        orderBook.addOrderToGroup(tick.Price, tick.OrderId);    // Adding unique Price
-    }
-
-    template<typename heap>
-    void processRemove(OrderBook<heap>& orderBook, Pattern& tick) {
-        orderBook.popOrder(tick.OrderId);
-        orderBook.popOrderFromGroup(tick.Price, tick.OrderId);  // Removes price if it's needed
-    }
-
-    template<typename bidHeap, typename askHeap>
-    void processTick(OrderBook<bidHeap>& bidOrderBook, OrderBook<askHeap>& askOrderBook, Pattern& tick) {
-        if (bidOrderBook.isAnyPrice()) {
-            uint32_t bestPrice = bidOrderBook.bestPrice();
-            tick.B0 = bestPrice;
-            tick.BQ0 = bidOrderBook.getBestShares();
-            tick.BN0 = bidOrderBook.getBestOrders();
-        }
-        if (askOrderBook.isAnyPrice()) {
-            uint32_t bestPrice = askOrderBook.bestPrice();
-            tick.A0 = bestPrice;
-            tick.AQ0 = askOrderBook.getBestShares();
-            tick.AN0 = askOrderBook.getBestOrders();
-        }
-    }
-
-    template<typename bidHeap, typename askHeap>
-    static void runActions(OrderBook<bidHeap>& bidOrderBook, OrderBook<askHeap>& askOrderBook, Pattern& tick) {
-        switch(tick.Action) {
-            case Action::clear1:
-                processClear<bidHeap, askHeap>(bidOrderBook, askOrderBook);
-                processTick<bidHeap, askHeap>(bidOrderBook, askOrderBook, tick);
-                break;
-            case Action::clear2:
-                processClear<bidHeap, askHeap>(bidOrderBook, askOrderBook);
-                processTick<bidHeap, askHeap>(bidOrderBook, askOrderBook, tick);
-                break;
-            case Action::add:
-                if (Side::bid == tick.Side) processAdd<bidHeap>(bidOrderBook, tick);
-                if (Side::ask == tick.Side) processAdd<askHeap>(askOrderBook, tick);
-                processTick<bidHeap, askHeap>(bidOrderBook, askOrderBook, tick);
-                break;
-            case Action::modify:
-                if (Side::bid == tick.Side) processModify<bidHeap>(bidOrderBook, tick);
-                if (Side::ask == tick.Side) processModify<askHeap>(askOrderBook, tick);
-                processTick<bidHeap, askHeap>(bidOrderBook, askOrderBook, tick);
-                break;
-            case Action::remove:
-                if (Side::bid == tick.Side) processRemove<bidHeap>(bidOrderBook, tick);
-                if (Side::ask == tick.Side) processRemove<askHeap>(askOrderBook, tick);
-                processTick<bidHeap, askHeap>(bidOrderBook, askOrderBook, tick);
-                break;
-            default:
-                break;
-        }
-    }
-
     std::string printCSV(Pattern& tick) {
         std::string csvStr = (std::to_string(tick.SourceTime) + ';');
         if (Side::ask != tick.Side && Side::bid != tick.Side) csvStr += ';';
@@ -127,39 +76,830 @@ namespace quant {
         return csvStr;
     }
 
-    void MsgReader::read() {
-        // Phase I - read file
-        std::deque<Pattern> ticks;
-        std::ifstream file(INPUT_FILE, std::ios::out | std::ios::binary);
-        while (file.peek() != EOF) {
-            Pattern tick;
-            readBinaryFile(file, tick);
-            ticks.push_back(std::move(tick));
+    /// @struct Level expected by scripted scenario
+    struct ScenarioLevel {
+        uint32_t price;
+        uint32_t shares;
+        uint32_t orders;
+    };
+
+    /// @struct One step of scripted scenario - action and whole expected book after it
+    struct ScenarioStep {
+        uint8_t action;
+        uint8_t side;
+        uint64_t orderID;
+        uint32_t price;
+        uint32_t qty;
+        /// @brief All levels of each side, the best first
+        std::vector<ScenarioLevel> bids;
+        std::vector<ScenarioLevel> asks;
+        /// @brief Orders of side of step with expected Orders and shares in front of them at their level
+        std::vector<std::pair<uint64_t, QueuePosition>> queue;
+    };
+
+    /// @brief Range of prices used by scripted scenario - every price inside it is checked after each step
+    constexpr uint32_t SCENARIO_LOW_PRICE = 95;
+    constexpr uint32_t SCENARIO_HIGH_PRICE = 110;
+
+    /**
+     * @brief Compare each price of scenario range of one side with expected levels, missing level has no shares
+     * @return Description of the first difference, empty if side is as expected
+     */
+    template<Side side>
+    static std::string compareLevels(const OrderBook<side>& orderBook, const std::vector<ScenarioLevel>& levels,
+                                     const char* name) {
+        for (uint32_t price = SCENARIO_LOW_PRICE; price <= SCENARIO_HIGH_PRICE; ++price) {
+            ScenarioLevel expected{price, 0, 0};
+            for (const ScenarioLevel& level : levels) {
+                if (level.price == price) expected = level;
+            }
+            const uint32_t shares = orderBook.noShares(price);
+            const uint32_t orders = orderBook.noOrders(price);
+            if (shares != expected.shares || orders != expected.orders) {
+                return std::string(name) + " level " + std::to_string(price) + ": expected "
+                       + std::to_string(expected.shares) + " shares of " + std::to_string(expected.orders)
+                       + " Orders, got " + std::to_string(shares) + " shares of " + std::to_string(orders)
+                       + " Orders";
+            }
+        }
+        return {};
+    }
+
+    /// @comment Modify used to add Order at new price without removing it from old level - the old level kept
+    ///          stale Order in its totals. Steps move Order to new best level and back into deeper level, change
+    ///          only qty (Order keeps its place), modify unknown Order, replace Order by add and drain both sides
+    bool MsgReader::checkPriceMoves() {
+        const std::vector<ScenarioStep> steps = {
+            {Action::add, Side::bid, 1, 100, 10, {{100, 10, 1}}, {}, {{1, {0, 0}}}},
+            {Action::add, Side::bid, 2, 100, 20, {{100, 30, 2}}, {}, {{2, {1, 10}}}},
+            {Action::add, Side::bid, 3, 99, 5, {{100, 30, 2}, {99, 5, 1}}, {}, {}},
+            {Action::modify, Side::bid, 1, 101, 10, {{101, 10, 1}, {100, 20, 1}, {99, 5, 1}}, {},
+             {{1, {0, 0}}, {2, {0, 0}}}},
+            {Action::modify, Side::bid, 1, 99, 10, {{100, 20, 1}, {99, 15, 2}}, {}, {{1, {1, 5}}}},
+            {Action::modify, Side::bid, 3, 99, 8, {{100, 20, 1}, {99, 18, 2}}, {}, {{3, {0, 0}}, {1, {1, 8}}}},
+            {Action::modify, Side::bid, 4, 98, 7, {{100, 20, 1}, {99, 18, 2}, {98, 7, 1}}, {}, {{4, {0, 0}}}},
+            {Action::add, Side::bid, 2, 99, 1, {{99, 19, 3}, {98, 7, 1}}, {}, {{2, {2, 18}}}},
+            {Action::remove, Side::bid, 3, 99, 8, {{99, 11, 2}, {98, 7, 1}}, {}, {{1, {0, 0}}, {2, {1, 10}}}},
+            {Action::modify, Side::ask, 1, 105, 4, {{99, 11, 2}, {98, 7, 1}}, {{105, 4, 1}}, {{1, {0, 0}}}},
+            {Action::modify, Side::ask, 1, 104, 6, {{99, 11, 2}, {98, 7, 1}}, {{104, 6, 1}}, {}},
+            {Action::remove, Side::bid, 1, 99, 10, {{99, 1, 1}, {98, 7, 1}}, {{104, 6, 1}}, {{2, {0, 0}}}},
+            {Action::remove, Side::bid, 1, 99, 10, {{99, 1, 1}, {98, 7, 1}}, {{104, 6, 1}}, {}},
+            {Action::remove, Side::bid, 2, 99, 1, {{98, 7, 1}}, {{104, 6, 1}}, {}},
+            {Action::remove, Side::bid, 4, 98, 7, {}, {{104, 6, 1}}, {}},
+            {Action::remove, Side::ask, 1, 104, 6, {}, {}, {}},
+        };
+
+        Book book;
+        for (std::size_t step = 0; step < steps.size(); ++step) {
+            const ScenarioStep& expected = steps[step];
+            Pattern tick{};
+            tick.SourceTime = step;
+            tick.Action = expected.action;
+            tick.Side = expected.side;
+            tick.OrderId = expected.orderID;
+            tick.Price = expected.price;
+            tick.Qty = expected.qty;
+            runActions(book, tick);
+
+            std::string difference = compareLevels(book.bidOrderBook, expected.bids, "bid");
+            if (difference.empty()) difference = compareLevels(book.askOrderBook, expected.asks, "ask");
+            const ScenarioLevel none{UINT32_MAX, UINT32_MAX, UINT32_MAX};
+            const ScenarioLevel bestBid = expected.bids.empty() ? none : expected.bids.front();
+            const ScenarioLevel bestAsk = expected.asks.empty() ? none : expected.asks.front();
+            if (difference.empty() && (tick.B0 != bestBid.price || tick.BQ0 != bestBid.shares
+                                       || tick.BN0 != bestBid.orders || tick.A0 != bestAsk.price
+                                       || tick.AQ0 != bestAsk.shares || tick.AN0 != bestAsk.orders)) {
+                difference = "result columns don't show the best levels";
+            }
+            for (const auto& [orderID, position] : expected.queue) {
+                if (!difference.empty()) break;
+                const std::optional<QueuePosition> got = Side::bid == expected.side
+                                                         ? book.bidOrderBook.queuePosition(orderID)
+                                                         : book.askOrderBook.queuePosition(orderID);
+                if (!got || got->ordersAhead != position.ordersAhead || got->sharesAhead != position.sharesAhead) {
+                    difference = "Order " + std::to_string(orderID) + ": expected "
+                                 + std::to_string(position.ordersAhead) + " Orders and "
+                                 + std::to_string(position.sharesAhead) + " shares ahead, got "
+                                 + (got ? std::to_string(got->ordersAhead) + " Orders and "
+                                          + std::to_string(got->sharesAhead) + " shares" : std::string("no Order"));
+                }
+            }
+            if (!difference.empty()) {
+                std::cout << "Price moves: wrong book after step " << step << ": " << printCSV(tick)
+                          << "  " << difference << std::endl;
+                return false;
+            }
+        }
+        std::cout << "Price moves: " << steps.size() << " steps of scripted scenario agree" << std::endl;
+        return true;
+    }
+
+    /// @struct One tick of scripted conflation - TopChange bits of tick and SourceTimes of rows written after it
+    struct ConflationStep {
+        uint64_t sourceTime;
+        uint8_t changed;
+        std::vector<uint64_t> rows;
+    };
+
+    /// @brief Interval of conflation used by scripted sequence
+    constexpr uint64_t SCENARIO_INTERVAL = 10;
+
+    /// @comment Held change released by later tick used to start next interval at SourceTime of releasing tick, so
+    ///          the following change was held too long. Each tick carries its SourceTime in deeper levels, so rows
+    ///          written from held tick are checked to have levels of that tick. The last step is finish
+    bool MsgReader::checkConflation() {
+        const std::vector<ConflationStep> steps = {
+            {100, bidTopChanged, {100}},
+            {105, bidTopChanged, {}},
+            {108, topUnchanged, {}},
+            {113, topUnchanged, {105}},
+            {116, bidTopChanged, {116}},
+            {118, askTopChanged, {118}},
+            {120, askTopChanged, {}},
+            {122, bidTopChanged, {}},
+            {129, topUnchanged, {122}},
+            {50, bidTopChanged, {50}},
+            {55, askTopChanged, {55}},
+            {58, askTopChanged, {}},
+            {0, topUnchanged, {58}},
+        };
+
+        RowFilter filter(OutputFilter::conflated, SCENARIO_INTERVAL, 2);
+        std::vector<uint64_t> rows;
+        std::string difference;
+        auto emit = [&](const Pattern& tick, const Quote* levels) {
+            rows.push_back(tick.SourceTime);
+            if (levels[0].Price != tick.SourceTime || levels[1].Price != tick.SourceTime) {
+                difference = "row " + std::to_string(tick.SourceTime) + " has levels of tick "
+                             + std::to_string(levels[0].Price);
+            }
+        };
+        for (std::size_t step = 0; step < steps.size(); ++step) {
+            const ConflationStep& expected = steps[step];
+            rows.clear();
+            if (step + 1 < steps.size()) {
+                Pattern tick{};
+                tick.SourceTime = expected.sourceTime;
+                const Quote levels[2] = {{static_cast<uint32_t>(expected.sourceTime), 1, 1},
+                                         {static_cast<uint32_t>(expected.sourceTime), 1, 1}};
+                filter.next(tick, levels, expected.changed, emit);
+            }
+            else filter.finish(emit);
+
+            if (difference.empty() && rows != expected.rows) {
+                auto print = [](const std::vector<uint64_t>& times) {
+                    std::string text = "[";
+                    for (uint64_t time : times) text += (text.size() > 1 ? " " : "") + std::to_string(time);
+                    return text + "]";
+                };
+                difference = "expected rows " + print(expected.rows) + ", got " + print(rows);
+            }
+            if (!difference.empty()) {
+                std::cout << "Conflation: wrong rows after step " << step << ": " << difference << std::endl;
+                return false;
+            }
+        }
+        std::cout << "Conflation: " << steps.size() << " steps of scripted sequence agree" << std::endl;
+        return true;
+    }
+
+    /// @brief Number of batches in flight in threaded streaming - together with TickBatch::CAPACITY bounds memory
+    constexpr std::size_t BATCHES_IN_FLIGHT = 8;
+    /// @brief Queue of batches between two threads of pipeline, nullptr marks end of input
+    using BatchRing = SpscRing<TickBatch*, BATCHES_IN_FLIGHT>;
+
+    /**
+     * @brief Decode next part of mapped file into batch
+     * @param file Mapped input binary file
+     * @param first Index of first record to decode
+     * @param batch Batch to fill, its size is set to number of decoded records
+     */
+    /// @comment Only byte swaps into columns are done here - ticks are made from columns by Order Book step
+    static void decodeBatch(const TickFile& file, std::size_t first, TickBatch& batch) {
+        batch.first = first;
+        batch.size = std::min(TickBatch::CAPACITY, file.size() - first);
+        if (batch.columns.size() < TickBatch::CAPACITY) batch.columns.resize(TickBatch::CAPACITY);
+        decodeColumns(file.at(first).data(), batch.size, batch.columns);
+    }
+
+    /// @comment Busy waiting with yield - pipeline stages are expected to be running all the time
+    static void pushBatch(BatchRing& ring, TickBatch* batch) {
+        while (!ring.push(batch)) std::this_thread::yield();
+    }
+
+    static TickBatch* popBatch(BatchRing& ring) {
+        TickBatch* batch;
+        while (!ring.pop(batch)) std::this_thread::yield();
+        return batch;
+    }
+
+    /// @brief Print number of ticks which went into filter and rows written by it
+    static void printRows(const RowFilter& filter) {
+        std::cout << "Ticks in: " << filter.ticks() << ", rows out: " << filter.rows() << " ("
+                  << (filter.ticks() > 0 ? 100.0 * static_cast<double_t>(filter.rows()) / filter.ticks() : 0.0)
+                  << "%)" << std::endl;
+    }
+
+    /**
+     * @brief Load the latest snapshot if it's requested
+     * @param file Input file
+     * @param options Settings of processing
+     * @param book Both sides of Order Book
+     * @return Index of the first tick to process
+     */
+    static std::size_t resumeBook(const TickFile& file, const ReaderOptions& options, Book& book) {
+        if (!options.resume) return 0;
+        if (OutputFilter::all != options.filter) {
+            throw std::invalid_argument("Resume needs output with all ticks - filtered rows can't be matched with snapshot");
+        }
+        std::optional<std::string> path = findSnapshot(options.checkpointDir, file.size());
+        if (!path) {
+            if (!options.quiet) std::cout << "No checkpoint found - processing from the beginning" << std::endl;
+            return 0;
+        }
+        Checkpoint checkpoint = loadSnapshot(*path, book);
+        // Snapshot of other input file (ex. other day with the same checkpoint directory) mustn't be continued
+        const uint64_t sourceTime = checkpoint.ticks > 0 ? (*file.at(checkpoint.ticks - 1)).SourceTime : 0;
+        if (checkpoint.ticks > 0 && sourceTime != checkpoint.sourceTime) {
+            throw std::runtime_error(*path + ": snapshot doesn't belong to " + options.inputFile + " - tick "
+                                     + std::to_string(checkpoint.ticks) + " has SourceTime " + std::to_string(sourceTime)
+                                     + ", snapshot " + std::to_string(checkpoint.sourceTime));
         }
-        file.close();
+        if (!options.quiet) {
+            std::cout << "Resumed from " << *path << " at tick " << checkpoint.ticks
+                      << " (SourceTime " << checkpoint.sourceTime << ")" << std::endl;
+        }
+        return checkpoint.ticks;
+    }
+
+    /**
+     * @brief Start output - header of new file, or rows of ticks before snapshot kept in existing file if processing
+     *        is resumed, so output always has rows of all ticks
+     * @tparam fileWriter CsvWriter or BinaryWriter
+     * @param outputPath Path to output file
+     * @param options Settings of processing
+     * @param first Index of the first tick to process, returned by @fn resumeBook
+     */
+    template<typename fileWriter>
+    static std::unique_ptr<fileWriter> openOutput(const std::string& outputPath, const ReaderOptions& options,
+                                                  std::size_t first) {
+        auto output = std::make_unique<fileWriter>(outputPath, first > 0);
+        if (first > 0) output->continueAfter(first, options.depth);
+        else output->writeHeader(options.depth);
+        return output;
+    }
+
+    /**
+     * @brief Phases of @fn MsgReader::read with given type of output
+     * @tparam fileWriter CsvWriter or BinaryWriter
+     * @param outputPath Path to output file
+     * @param options Settings of processing
+     */
+    template<typename fileWriter>
+    static ReplayStats readFile(const std::string& outputPath, const ReaderOptions& options) {
+        // Phase I - map file, records are decoded in place during Phase II
+        TickFile file(options.inputFile);
+        std::vector<Pattern> ticks;
+        ticks.reserve(file.size());
+        std::vector<uint8_t> changes;
+        changes.reserve(file.size());
+        const std::size_t depthSize = 2 * (options.depth - 1);
+        std::vector<Quote> levels(depthSize * file.size());
 
         // Phase II - create OB
-        OrderBook<bidHeap> bidOrderBook;
-        OrderBook<askHeap> askOrderBook;
+        Book book(options.capacity);
+        const std::size_t first = resumeBook(file, options, book);
+        const auto output = openOutput<fileWriter>(outputPath, options, first);
+        Checkpointer checkpoints(options.checkpointDir, options.checkpointEvery, options.checkpointOnClear);
         auto start = std::chrono::high_resolution_clock::now();
-        for (Pattern& tick : ticks) {
-            runActions<bidHeap, askHeap>(bidOrderBook, askOrderBook, tick);
+        for (auto record = file.at(first); record != file.end(); ++record) {
+            Pattern tick = *record;
+            changes.push_back(runActions(book, tick));
+            if (options.view) options.view->publish(book, tick);
+            if (depthSize > 0) {
+                processDepth(book, options.depth, &levels[ticks.size() * depthSize]);
+            }
+            ticks.push_back(tick);
+            checkpoints.after(book, tick, first + ticks.size());
         }
         auto end = std::chrono::high_resolution_clock::now();
 
         // Phase III - write output to file
-        std::ofstream csvFile(OUTPUT_FILE);
-        csvFile << "SourceTime;Side;Action;OrderId;Price;Qty;B0;BQ0;BN0;A0;AQ0;AN0\n";
-        for (Pattern& tick: ticks) {
-            csvFile << printCSV(tick);
+        RowFilter filter(options.filter, options.conflateInterval, depthSize);
+        auto emit = [&](const Pattern& tick, const Quote* tickLevels) { output->write(tick, tickLevels, options.depth); };
+        for (std::size_t i = 0; i < ticks.size(); ++i) {
+            filter.next(ticks[i], levels.data() + i * depthSize, changes[i], emit);
         }
-        csvFile.close();
+        filter.finish(emit);
+        output->flush();
 
         // Printing on console time of building OB
         auto tickDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        std::cout << "Total time of building OB: " << tickDuration.count() << " us" << std::endl;
-        std::cout << "Avg time per tick: "
-        << (static_cast<double_t>(tickDuration.count()) / static_cast<double_t>(ticks.size()))
-        << " us" << std::endl;
+        if (!options.quiet) {
+            std::cout << "Total time of building OB: " << tickDuration.count() << " us" << std::endl;
+            std::cout << "Avg time per tick: "
+            << (static_cast<double_t>(tickDuration.count()) / static_cast<double_t>(ticks.size()))
+            << " us" << std::endl;
+            if (checkpoints.written() > 0) std::cout << "Checkpoints written: " << checkpoints.written() << std::endl;
+            if (OutputFilter::all != options.filter) printRows(filter);
+        }
+        return ReplayStats{ticks.size(), filter.rows(), end - start};
+    }
+
+    /**
+     * @brief Pipeline of @fn MsgReader::stream with given type of output
+     * @tparam fileWriter CsvWriter or BinaryWriter
+     * @param outputPath Path to output file
+     * @param options Settings of processing
+     */
+    template<typename fileWriter>
+    static ReplayStats streamFile(const std::string& outputPath, const ReaderOptions& options) {
+        TickFile file(options.inputFile);
+        const std::size_t depthSize = 2 * (options.depth - 1);
+
+        Book book(options.capacity);
+        const std::size_t start = resumeBook(file, options, book);
+        const auto output = openOutput<fileWriter>(outputPath, options, start);
+        Checkpointer checkpoints(options.checkpointDir, options.checkpointEvery, options.checkpointOnClear);
+        // Time of each phase is summed over batches - every phase is measured only by thread running it
+        std::chrono::high_resolution_clock::duration decodeDuration{0}, buildDuration{0}, writeDuration{0};
+
+        auto decode = [&](std::size_t first, TickBatch& batch) {
+            auto start = std::chrono::high_resolution_clock::now();
+            decodeBatch(file, first, batch);
+            decodeDuration += std::chrono::high_resolution_clock::now() - start;
+            file.release(first + batch.size);
+        };
+        auto build = [&](TickBatch& batch) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (std::size_t i = 0; i < batch.size; ++i) {
+                batch.ticks[i] = batch.columns.tick(i);
+                batch.changes[i] = runActions(book, batch.ticks[i]);
+                if (options.view) options.view->publish(book, batch.ticks[i]);
+                if (depthSize > 0) {
+                    processDepth(book, options.depth, &batch.levels[i * depthSize]);
+                }
+                checkpoints.after(book, batch.ticks[i], batch.first + i + 1);
+            }
+            buildDuration += std::chrono::high_resolution_clock::now() - start;
+        };
+        RowFilter filter(options.filter, options.conflateInterval, depthSize);
+        auto emit = [&](const Pattern& tick, const Quote* tickLevels) { output->write(tick, tickLevels, options.depth); };
+        auto write = [&](TickBatch& batch) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (std::size_t i = 0; i < batch.size; ++i) {
+                filter.next(batch.ticks[i], batch.levels.data() + i * depthSize, batch.changes[i], emit);
+            }
+            writeDuration += std::chrono::high_resolution_clock::now() - start;
+        };
+
+        if (!options.threaded) {
+            auto batch = std::make_unique<TickBatch>();
+            batch->levels.resize(TickBatch::CAPACITY * depthSize);
+            for (std::size_t first = start; first < file.size(); first += batch->size) {
+                decode(first, *batch);
+                build(*batch);
+                write(*batch);
+            }
+        }
+        else {
+            // Batches go around: free -> decoder -> Order Book (this thread) -> writer -> free
+            std::vector<TickBatch> batches(BATCHES_IN_FLIGHT);
+            auto freeBatches = std::make_unique<BatchRing>();
+            auto decodedBatches = std::make_unique<BatchRing>();
+            auto builtBatches = std::make_unique<BatchRing>();
+            for (TickBatch& batch : batches) {
+                batch.levels.resize(TickBatch::CAPACITY * depthSize);
+                pushBatch(*freeBatches, &batch);
+            }
+
+            std::thread decoder([&] {
+                for (std::size_t first = start; first < file.size();) {
+                    TickBatch* batch = popBatch(*freeBatches);
+                    decode(first, *batch);
+                    first += batch->size;
+                    pushBatch(*decodedBatches, batch);
+                }
+                pushBatch(*decodedBatches, nullptr);
+            });
+            std::thread writer([&] {
+                for (TickBatch* batch = popBatch(*builtBatches); batch; batch = popBatch(*builtBatches)) {
+                    write(*batch);
+                    pushBatch(*freeBatches, batch);
+                }
+            });
+            for (TickBatch* batch = popBatch(*decodedBatches); batch; batch = popBatch(*decodedBatches)) {
+                build(*batch);
+                pushBatch(*builtBatches, batch);
+            }
+            pushBatch(*builtBatches, nullptr);
+            decoder.join();
+            writer.join();
+        }
+        filter.finish(emit);
+        output->flush();
+
+        // Printing on console time of each phase
+        auto decodeTime = std::chrono::duration_cast<std::chrono::microseconds>(decodeDuration);
+        auto tickDuration = std::chrono::duration_cast<std::chrono::microseconds>(buildDuration);
+        auto writeTime = std::chrono::duration_cast<std::chrono::microseconds>(writeDuration);
+        if (!options.quiet) {
+            std::cout << "Total time of decoding (" << decoderName(activeDecoder()) << "): " << decodeTime.count()
+                      << " us" << std::endl;
+            std::cout << "Total time of building OB: " << tickDuration.count() << " us" << std::endl;
+            std::cout << "Avg time per tick: "
+            << (static_cast<double_t>(tickDuration.count()) / static_cast<double_t>(file.size() - start))
+            << " us" << std::endl;
+            std::cout << "Total time of writing: " << writeTime.count() << " us" << std::endl;
+            if (checkpoints.written() > 0) std::cout << "Checkpoints written: " << checkpoints.written() << std::endl;
+            if (OutputFilter::all != options.filter) printRows(filter);
+        }
+        return ReplayStats{file.size() - start, filter.rows(), buildDuration};
+    }
+
+    /**
+     * @brief Processing of @fn MsgReader::live with given type of output
+     * @tparam fileWriter CsvWriter or BinaryWriter
+     * @param outputPath Path to output file
+     * @param options Settings of processing
+     */
+    /// @comment One thread receives, builds and writes - there is no queue between receive and Order Book, so
+    ///          latency of tick is bounded by size of one receive (FeedSource::READ_SIZE or DATAGRAMS)
+    template<typename fileWriter>
+    static ReplayStats liveFeed(const std::string& outputPath, const ReaderOptions& options) {
+        FeedSource feed(parseFeed(options.feed));
+        fileWriter output(outputPath);
+        output.writeHeader(options.depth);
+        const std::size_t depthSize = 2 * (options.depth - 1);
+
+        Book book(options.capacity);
+        Checkpointer checkpoints(options.checkpointDir, options.checkpointEvery, options.checkpointOnClear);
+        RowFilter filter(options.filter, options.conflateInterval, depthSize);
+        auto emit = [&](const Pattern& tick, const Quote* tickLevels) { output.write(tick, tickLevels, options.depth); };
+        auto batch = std::make_unique<TickBatch>();
+        batch->columns.resize(TickBatch::CAPACITY);
+        batch->levels.resize(TickBatch::CAPACITY * depthSize);
+        LatencyHistogram latency;
+        std::chrono::high_resolution_clock::duration buildDuration{0};
+        std::size_t ticks = 0;
+
+        const unsigned char* records;
+        for (std::size_t count = feed.receive(records); count > 0; count = feed.receive(records)) {
+            auto received = std::chrono::high_resolution_clock::now();
+            for (std::size_t first = 0; first < count; first += batch->size) {
+                batch->size = std::min(TickBatch::CAPACITY, count - first);
+                decodeColumns(records + first * RECORD_SIZE, batch->size, batch->columns);
+                for (std::size_t i = 0; i < batch->size; ++i) {
+                    batch->ticks[i] = batch->columns.tick(i);
+                    batch->changes[i] = runActions(book, batch->ticks[i]);
+                    if (options.view) options.view->publish(book, batch->ticks[i]);
+                    if (depthSize > 0) {
+                        processDepth(book, options.depth, &batch->levels[i * depthSize]);
+                    }
+                    checkpoints.after(book, batch->ticks[i], ++ticks);
+                }
+                if (first + batch->size == count) {
+                    auto published = std::chrono::high_resolution_clock::now();
+                    latency.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(published - received).count()));
+                    buildDuration += published - received;
+                }
+                for (std::size_t i = 0; i < batch->size; ++i) {
+                    filter.next(batch->ticks[i], batch->levels.data() + i * depthSize, batch->changes[i], emit);
+                }
+            }
+            output.flush();
+        }
+        filter.finish(emit);
+        output.flush();
+
+        if (!options.quiet) {
+            const FeedStats& stats = feed.stats();
+            std::cout << "Ticks received: " << ticks << " in " << stats.reads << " reads ("
+                      << (stats.reads > 0 ? static_cast<double_t>(ticks) / static_cast<double_t>(stats.reads) : 0.0)
+                      << " ticks per read)" << std::endl;
+            if (stats.dropped > 0) std::cout << "Bytes not forming complete record: " << stats.dropped << std::endl;
+            std::cout << "Receive to publish: mean " << latency.mean() / 1e3 << " us, p99 "
+                      << static_cast<double_t>(latency.percentile(0.99)) / 1e3 << " us, max "
+                      << static_cast<double_t>(latency.max()) / 1e3 << " us" << std::endl;
+            if (checkpoints.written() > 0) std::cout << "Checkpoints written: " << checkpoints.written() << std::endl;
+            if (OutputFilter::all != options.filter) printRows(filter);
+        }
+        return ReplayStats{ticks, filter.rows(), buildDuration};
+    }
+
+    /// @comment Handler only interrupts blocking receive (no SA_RESTART) - output is flushed before exit
+    static void interruptFeed(int) {}
+
+    /// @comment Empty output file in options means default file of given format
+    static std::string outputPathOf(const ReaderOptions& options) {
+        if (!options.outputFile.empty()) return options.outputFile;
+        return OutputFormat::binary == options.format ? BINARY_OUTPUT_FILE : OUTPUT_FILE;
+    }
+
+    ReplayStats MsgReader::read(const ReaderOptions& options) {
+        if (OutputFormat::binary == options.format) return readFile<BinaryWriter>(outputPathOf(options), options);
+        return readFile<CsvWriter>(outputPathOf(options), options);
+    }
+
+    ReplayStats MsgReader::stream(const ReaderOptions& options) {
+        if (OutputFormat::binary == options.format) return streamFile<BinaryWriter>(outputPathOf(options), options);
+        return streamFile<CsvWriter>(outputPathOf(options), options);
+    }
+
+    ReplayStats MsgReader::live(const ReaderOptions& options) {
+        struct sigaction action{}, previousInt{}, previousTerm{};
+        action.sa_handler = interruptFeed;
+        sigemptyset(&action.sa_mask);
+        ::sigaction(SIGINT, &action, &previousInt);
+        ::sigaction(SIGTERM, &action, &previousTerm);
+        ReplayStats stats = OutputFormat::binary == options.format
+                            ? liveFeed<BinaryWriter>(outputPathOf(options), options)
+                            : liveFeed<CsvWriter>(outputPathOf(options), options);
+        ::sigaction(SIGINT, &previousInt, nullptr);
+        ::sigaction(SIGTERM, &previousTerm, nullptr);
+        return stats;
+    }
+
+    /// @comment Extended records are made in chunks, so memory doesn't grow with number of instruments
+    void MsgReader::replayInstruments(const ReaderOptions& options, std::size_t instruments, std::size_t workers) {
+        constexpr std::size_t CHUNK_RECORDS = 1 << 16;
+        TickFile file(options.inputFile);
+        std::vector<unsigned char> chunk(CHUNK_RECORDS * EXTENDED_RECORD_SIZE);
+        std::chrono::high_resolution_clock::duration encodeDuration{0};
+
+        auto start = std::chrono::high_resolution_clock::now();
+        BookManager manager(workers, options.capacity);
+        std::size_t used = 0;
+        auto routeChunk = [&] {
+            for (std::size_t offset = 0; offset < used; offset += EXTENDED_RECORD_SIZE) {
+                manager.route(chunk.data() + offset);
+            }
+            used = 0;
+        };
+        for (auto record = file.begin(); record != file.end(); ++record) {
+            auto encodeStart = std::chrono::high_resolution_clock::now();
+            for (uint32_t instrumentId = 0; instrumentId < instruments; ++instrumentId) {
+                uint32_t id = htonl(instrumentId);
+                std::memcpy(chunk.data() + used, &id, sizeof(id));
+                std::memcpy(chunk.data() + used + sizeof(id), record.data(), RECORD_SIZE);
+                used += EXTENDED_RECORD_SIZE;
+                if (used == chunk.size()) {
+                    encodeDuration += std::chrono::high_resolution_clock::now() - encodeStart;
+                    routeChunk();
+                    encodeStart = std::chrono::high_resolution_clock::now();
+                }
+            }
+            encodeDuration += std::chrono::high_resolution_clock::now() - encodeStart;
+        }
+        routeChunk();
+        manager.finish();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        // Printing on console throughput without time of making synthetic input
+        auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start - encodeDuration);
+        std::size_t ticks = 0;
+        auto stats = manager.stats();
+        for (std::size_t worker = 0; worker < stats.size(); ++worker) {
+            std::cout << "Worker " << worker << ": " << stats[worker].instruments << " instruments, "
+            << stats[worker].ticks << " ticks" << std::endl;
+            ticks += stats[worker].ticks;
+        }
+        std::cout << "Total time of building OBs: " << totalTime.count() << " us" << std::endl;
+        std::cout << "Throughput: "
+        << (static_cast<double_t>(ticks) * 1e6 / static_cast<double_t>(std::max<int64_t>(totalTime.count(), 1)))
+        << " ticks/s" << std::endl;
+    }
+
+    /// @comment Every decoder gets the same blocks as streaming pipeline, so tail of block shorter than vector width
+    ///          is checked too
+    bool MsgReader::checkDecoders(const ReaderOptions& options) {
+        std::ifstream inputFile(options.inputFile, std::ios::binary);
+        if (!inputFile) throw std::system_error(errno, std::generic_category(), options.inputFile);
+        TickFile file(options.inputFile, false);
+        std::vector<Pattern> reference(file.size());
+        for (Pattern& tick : reference) readBinaryFile(inputFile, tick);
+
+        bool agree = true;
+        TickColumns columns;
+        columns.resize(TickBatch::CAPACITY);
+        for (DecoderKind kind : {DecoderKind::scalar, DecoderKind::ssse3, DecoderKind::avx2}) {
+            if (!decoderSupported(kind)) {
+                std::cout << decoderName(kind) << ": not supported by CPU" << std::endl;
+                continue;
+            }
+            std::size_t mismatch = file.size();
+            for (std::size_t first = 0; first < file.size() && mismatch == file.size(); first += TickBatch::CAPACITY) {
+                std::size_t size = std::min(TickBatch::CAPACITY, file.size() - first);
+                decodeColumns(kind, file.at(first).data(), size, columns);
+                for (std::size_t i = 0; i < size; ++i) {
+                    const Pattern& expected = reference[first + i];
+                    if (columns.SourceTime[i] != expected.SourceTime || columns.Side[i] != expected.Side
+                        || columns.Action[i] != expected.Action || columns.OrderId[i] != expected.OrderId
+                        || columns.Price[i] != expected.Price || columns.Qty[i] != expected.Qty) {
+                        mismatch = first + i;
+                        break;
+                    }
+                }
+            }
+            if (mismatch == file.size()) {
+                std::cout << decoderName(kind) << ": " << file.size() << " records bit-exact" << std::endl;
+                continue;
+            }
+            agree = false;
+            Pattern decoded = columns.tick(mismatch % TickBatch::CAPACITY);
+            std::cout << decoderName(kind) << ": record " << mismatch << " differs - expected "
+                      << printCSV(reference[mismatch]) << "got " << printCSV(decoded);
+        }
+        return agree;
+    }
+
+    /// @brief Whole content of file - outputs are compared byte by byte
+    static std::string contentOf(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::system_error(errno, std::generic_category(), path);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    /// @comment Snapshot is written once in the middle of input and the last quarter of output is cut (usually in
+    ///          the middle of row), as if process was killed after the snapshot. Everything is done in temporary
+    ///          directory, so results and snapshots of real runs stay untouched
+    bool MsgReader::checkResume(const ReaderOptions& options) {
+        const std::size_t ticks = TickFile(options.inputFile).size();
+        const std::filesystem::path directory = std::filesystem::temp_directory_path()
+                                                / ("order_book_resume_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        ReaderOptions base = options;
+        base.checkpointDir = (directory / "checkpoints").string();
+        base.checkpointEvery = 0;
+        base.checkpointOnClear = false;
+        base.resume = false;
+        base.quiet = true;
+        base.filter = OutputFilter::all;
+        base.view = nullptr;
+        const std::size_t snapshotTick = ticks / 2 + 1;
+        const std::string extension = OutputFormat::binary == options.format ? ".bin" : ".csv";
+
+        bool agree = true;
+        for (bool streamed : {false, true}) {
+            const std::string mode = !streamed ? "read" : options.threaded ? "threaded" : "stream";
+            auto run = [streamed](const ReaderOptions& runOptions) {
+                return streamed ? stream(runOptions) : read(runOptions);
+            };
+            ReaderOptions whole = base;
+            whole.outputFile = (directory / (mode + "_whole" + extension)).string();
+            run(whole);
+
+            ReaderOptions interrupted = base;
+            interrupted.outputFile = (directory / (mode + "_resumed" + extension)).string();
+            interrupted.checkpointEvery = snapshotTick;
+            std::filesystem::remove_all(interrupted.checkpointDir);
+            run(interrupted);
+            const auto size = std::filesystem::file_size(interrupted.outputFile);
+            std::filesystem::resize_file(interrupted.outputFile, size - size / 4);
+            interrupted.checkpointEvery = 0;
+            interrupted.resume = true;
+            run(interrupted);
+
+            const std::string expected = contentOf(whole.outputFile);
+            const std::string resumed = contentOf(interrupted.outputFile);
+            if (expected == resumed) {
+                std::cout << "Resume (" << mode << "): output resumed at tick " << snapshotTick << " of " << ticks
+                          << " is the same as uninterrupted (" << expected.size() << " bytes)" << std::endl;
+                continue;
+            }
+            agree = false;
+            const auto difference = std::mismatch(expected.begin(), expected.end(), resumed.begin(), resumed.end());
+            std::cout << "Resume (" << mode << "): output resumed at tick " << snapshotTick << " differs from"
+                      << " uninterrupted at byte " << (difference.first - expected.begin()) << " (sizes "
+                      << expected.size() << " and " << resumed.size() << ")" << std::endl;
+        }
+        std::filesystem::remove_all(directory);
+        return agree;
+    }
+
+    /// @struct Work of one reader thread of @fn MsgReader::stressView
+    struct ViewReadStats {
+        std::size_t reads = 0;
+        std::size_t retries = 0;
+        std::size_t errors = 0;
+    };
+
+    /**
+     * @brief Run writer while reader threads poll view with @fn BookView::tryRead
+     * @param view View published by writer
+     * @param readers Number of reader threads
+     * @param check Called by readers for each snapshot read, returns false if snapshot is wrong
+     * @param writer Publishing function run on calling thread
+     * @return Sum of work of all readers
+     */
+    /// @comment Number of ticks of snapshots seen by one reader can't go back - that is checked here as well
+    template<typename Check, typename Writer>
+    static ViewReadStats pollView(const BookView& view, std::size_t readers, Check check, Writer writer) {
+        std::atomic<bool> done{false};
+        std::vector<ViewReadStats> stats(readers);
+        std::vector<std::thread> threads;
+        for (std::size_t reader = 0; reader < readers; ++reader) {
+            threads.emplace_back([&, reader] {
+                ViewReadStats& own = stats[reader];
+                BookSnapshot snapshot;
+                uint64_t lastTicks = 0;
+                while (!done.load(std::memory_order_acquire)) {
+                    if (!view.tryRead(snapshot)) {
+                        ++own.retries;
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    ++own.reads;
+                    if (snapshot.ticks < lastTicks || !check(snapshot)) ++own.errors;
+                    lastTicks = snapshot.ticks;
+                }
+            });
+        }
+        writer();
+        done.store(true, std::memory_order_release);
+        for (std::thread& thread : threads) thread.join();
+
+        ViewReadStats total;
+        for (const ViewReadStats& own : stats) {
+            total.reads += own.reads;
+            total.retries += own.retries;
+            total.errors += own.errors;
+        }
+        return total;
+    }
+
+    static void printViewStats(const char* phase, std::size_t readers, const ViewReadStats& stats) {
+        std::cout << phase << ": " << readers << " readers, " << stats.reads << " snapshots read, " << stats.retries
+                  << " retries, " << stats.errors << " inconsistent" << std::endl;
+    }
+
+    /// @comment Synthetic writer makes every field a function of number of ticks, so any mix of two publishes
+    ///          is visible. Replay checks what real book guarantees - order of prices and number of levels
+    bool MsgReader::stressView(const ReaderOptions& options, std::size_t readers) {
+        constexpr uint64_t SYNTHETIC_PUBLISHES = 1 << 20;
+        BookView view(options.depth);
+        const std::size_t depth = view.depth();
+        readers = std::max<std::size_t>(readers, 1);
+
+        auto syntheticLevel = [](uint64_t ticks, std::size_t level) {
+            const auto value = static_cast<uint32_t>(ticks * 7 + level);
+            return LevelPair{Quote{value, value + 1, value + 2}, Quote{value + 3, value + 4, value + 5}};
+        };
+        ViewReadStats synthetic = pollView(view, readers, [&](const BookSnapshot& snapshot) {
+            if (snapshot.ticks == 0) return true;
+            if (snapshot.sourceTime != snapshot.ticks * 3 || snapshot.bidLevels != static_cast<uint32_t>(snapshot.ticks)
+                || snapshot.askLevels != static_cast<uint32_t>(snapshot.ticks + 1)) return false;
+            for (std::size_t level = 0; level < depth; ++level) {
+                const LevelPair expected = syntheticLevel(snapshot.ticks, level);
+                if (snapshot.levels[level].bid != expected.bid || snapshot.levels[level].ask != expected.ask) return false;
+            }
+            return true;
+        }, [&] {
+            BookSnapshot snapshot;
+            for (uint64_t ticks = 1; ticks <= SYNTHETIC_PUBLISHES; ++ticks) {
+                snapshot.ticks = ticks;
+                snapshot.sourceTime = ticks * 3;
+                snapshot.bidLevels = static_cast<uint32_t>(ticks);
+                snapshot.askLevels = static_cast<uint32_t>(ticks + 1);
+                for (std::size_t level = 0; level < depth; ++level) snapshot.levels[level] = syntheticLevel(ticks, level);
+                view.publish(snapshot);
+            }
+        });
+        printViewStats("synthetic", readers, synthetic);
+
+        BookView replayView(depth);
+        // Replay is only a writer of view - it mustn't touch output file or snapshots of real run
+        ReaderOptions replayOptions = options;
+        replayOptions.view = &replayView;
+        replayOptions.quiet = true;
+        replayOptions.outputFile = "/dev/null";
+        replayOptions.resume = false;
+        replayOptions.checkpointEvery = 0;
+        replayOptions.checkpointOnClear = false;
+        ReplayStats stats;
+        ViewReadStats replay = pollView(replayView, readers, [&](const BookSnapshot& snapshot) {
+            for (std::size_t level = 0; level < depth; ++level) {
+                const LevelPair& pair = snapshot.levels[level];
+                if ((pair.bid.Price != UINT32_MAX) != (level < snapshot.bidLevels)) return false;
+                if ((pair.ask.Price != UINT32_MAX) != (level < snapshot.askLevels)) return false;
+                if (level == 0) continue;
+                const LevelPair& better = snapshot.levels[level - 1];
+                if (level < snapshot.bidLevels && pair.bid.Price >= better.bid.Price) return false;
+                if (level < snapshot.askLevels && pair.ask.Price <= better.ask.Price) return false;
+            }
+            return true;
+        }, [&] { stats = read(replayOptions); });
+        printViewStats("replay", readers, replay);
+
+        BookSnapshot last;
+        replayView.read(last);
+        const bool complete = last.ticks == stats.ticks;
+        if (!complete) {
+            std::cout << "replay: last snapshot after " << last.ticks << " of " << stats.ticks << " ticks" << std::endl;
+        }
+        return synthetic.errors == 0 && replay.errors == 0 && complete;
     }
-} // quant
\ No newline at end of file
+} // quant
@@ -0,0 +1,21 @@
+/**
+ * @file    OrderPool.cpp
+ * @brief   Source code of preallocated slab of Order records
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include "OrderPool.h"
+
+namespace quant {
+    OrderPool::OrderPool(std::size_t capacity) {
+        _slab.reserve(capacity);
+    }
+
+    /// @comment Capacity of slab stays untouched - next Orders are taken again from the beginning
+    void OrderPool::clear() {
+        _slab.clear();
+        _freeList = NO_HANDLE;
+        _size = 0;
+    }
+} // quant
@@ -0,0 +1,76 @@
+/**
+ * @file    ReferenceBook.cpp
+ * @brief   Source code of slow and simple Order Book used as oracle by validation
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <iterator>
+
+#include "ReferenceBook.h"
+
+namespace quant {
+    /// @comment Existing Order is removed first - replaced Order goes to the end of queue like a new one
+    void ReferenceBook::RefSide::add(uint64_t orderID, uint32_t price, uint32_t qty) {
+        remove(orderID);
+        orders[orderID] = RefOrder{price, qty};
+        RefLevel& level = levels[price];
+        level.shares += qty;
+        ++level.orders;
+    }
+
+    void ReferenceBook::RefSide::remove(uint64_t orderID) {
+        auto order = orders.find(orderID);
+        if (order == orders.end()) return;
+        auto level = levels.find(order->second.price);
+        level->second.shares -= order->second.qty;
+        if (--level->second.orders == 0) levels.erase(level);
+        orders.erase(order);
+    }
+
+    void ReferenceBook::apply(const Pattern& tick) {
+        if (Action::clear1 == tick.Action || Action::clear2 == tick.Action) {
+            _bid = RefSide{};
+            _ask = RefSide{};
+            return;
+        }
+        if (Side::bid != tick.Side && Side::ask != tick.Side) return;
+        RefSide& side = of(static_cast<Side>(tick.Side));
+        switch (tick.Action) {
+            case Action::add:
+                side.add(tick.OrderId, tick.Price, tick.Qty);
+                break;
+            case Action::modify: {
+                auto order = side.orders.find(tick.OrderId);
+                if (order != side.orders.end() && order->second.price == tick.Price) {
+                    // Change of quantity only - Order keeps its place
+                    side.levels[tick.Price].shares += tick.Qty - order->second.qty;
+                    order->second.qty = tick.Qty;
+                }
+                else side.add(tick.OrderId, tick.Price, tick.Qty);
+                break;
+            }
+            case Action::remove:
+                side.remove(tick.OrderId);
+                break;
+            default:
+                break;
+        }
+    }
+
+    Quote ReferenceBook::level(Side side, std::size_t depth) const {
+        const auto& levels = of(side).levels;
+        if (depth >= levels.size()) return Quote{};
+        auto level = Side::bid == side ? std::prev(levels.end(), static_cast<std::ptrdiff_t>(depth) + 1)
+                                       : std::next(levels.begin(), static_cast<std::ptrdiff_t>(depth));
+        return Quote{level->first, level->second.shares, level->second.orders};
+    }
+
+    std::size_t ReferenceBook::noLevels(Side side) const {
+        return of(side).levels.size();
+    }
+
+    std::size_t ReferenceBook::noOrders(Side side) const {
+        return of(side).orders.size();
+    }
+} // quant
@@ -0,0 +1,137 @@
+/**
+ * @file    ReplayDriver.cpp
+ * @brief   Source code of replay of many input files at once
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "ReplayDriver.h"
+
+namespace quant {
+    ReplayDriver::ReplayDriver(std::string outputDir, ReaderOptions options, bool stream)
+        : _outputDir(std::move(outputDir)), _options(std::move(options)), _stream(stream) {
+        _options.quiet = true;
+        std::filesystem::create_directories(_outputDir);
+    }
+
+    std::vector<std::string> ReplayDriver::collectInputs(const std::vector<std::string>& paths) {
+        std::vector<std::string> inputs;
+        for (const std::string& path : paths) {
+            if (!std::filesystem::is_directory(path)) {
+                inputs.push_back(path);
+                continue;
+            }
+            std::vector<std::string> found;
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".raw") found.push_back(entry.path().string());
+            }
+            std::sort(found.begin(), found.end());
+            inputs.insert(inputs.end(), found.begin(), found.end());
+        }
+        return inputs;
+    }
+
+    /// @comment Names are checked before any file is processed - colliding outputs or checkpoint directories would
+    ///          be overwritten by threads in parallel
+    std::vector<std::string> ReplayDriver::namesOf(const std::vector<std::string>& inputs) {
+        std::unordered_map<std::string, std::size_t> stems;
+        for (const std::string& input : inputs) ++stems[std::filesystem::path(input).stem().string()];
+
+        std::vector<std::string> names;
+        std::unordered_map<std::string, std::size_t> owners;
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            const std::filesystem::path path = std::filesystem::absolute(inputs[i]).lexically_normal();
+            std::string name = path.stem().string();
+            if (stems[std::filesystem::path(inputs[i]).stem().string()] > 1) {
+                name = path.parent_path().filename().string() + "_" + name;
+            }
+            const auto [owner, added] = owners.emplace(name, i);
+            if (!added) {
+                throw std::invalid_argument("Inputs " + inputs[owner->second] + " and " + inputs[i]
+                                            + " have the same output name " + name);
+            }
+            names.push_back(std::move(name));
+        }
+        return names;
+    }
+
+    std::string ReplayDriver::outputFor(const std::string& name) const {
+        std::filesystem::path output = std::filesystem::path(_outputDir) / name;
+        output += OutputFormat::binary == _options.format ? ".bin" : ".csv";
+        return output.string();
+    }
+
+    /// @comment Snapshots of each file go to own subdirectory, so files with checkpoints don't mix them up
+    FileReport ReplayDriver::process(const std::string& input, const std::string& name) const {
+        FileReport report;
+        report.input = input;
+        report.output = outputFor(name);
+        ReaderOptions options = _options;
+        options.inputFile = input;
+        options.outputFile = report.output;
+        options.checkpointDir = (std::filesystem::path(_options.checkpointDir) / name).string();
+        auto start = std::chrono::steady_clock::now();
+        try {
+            report.stats = _stream ? MsgReader::stream(options) : MsgReader::read(options);
+        }
+        catch (const std::exception& error) {
+            report.error = error.what();
+        }
+        report.wallTime = std::chrono::steady_clock::now() - start;
+        return report;
+    }
+
+    /// @comment Files are handed out by shared counter - threads which finish small files take next ones
+    std::vector<FileReport> ReplayDriver::run(const std::vector<std::string>& inputs, std::size_t threads) const {
+        const std::vector<std::string> names = namesOf(inputs);
+        std::vector<FileReport> reports(inputs.size());
+        std::atomic<std::size_t> next{0};
+        auto work = [&] {
+            for (std::size_t i = next++; i < inputs.size(); i = next++) reports[i] = process(inputs[i], names[i]);
+        };
+
+        std::vector<std::thread> pool;
+        threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(inputs.size(), 1));
+        for (std::size_t i = 1; i < threads; ++i) pool.emplace_back(work);
+        work();
+        for (std::thread& thread : pool) thread.join();
+        return reports;
+    }
+
+    void ReplayDriver::report(std::ostream& output, const std::vector<FileReport>& reports,
+                              std::chrono::nanoseconds wallTime) {
+        std::size_t ticks = 0;
+        std::size_t failed = 0;
+        for (const FileReport& report : reports) {
+            if (!report.error.empty()) {
+                ++failed;
+                output << report.input << ": FAILED - " << report.error << '\n';
+                continue;
+            }
+            ticks += report.stats.ticks;
+            const double seconds = std::chrono::duration<double>(report.wallTime).count();
+            const double buildSeconds = std::chrono::duration<double>(report.stats.buildTime).count();
+            output << report.input << " -> " << report.output << ": " << report.stats.ticks << " ticks, ";
+            if (report.stats.rows != report.stats.ticks) output << report.stats.rows << " rows, ";
+            output << std::fixed << std::setprecision(1) << seconds * 1e3 << " ms, "
+                   << std::setprecision(0) << (seconds > 0 ? report.stats.ticks / seconds : 0) << " ticks/s (build "
+                   << (buildSeconds > 0 ? report.stats.ticks / buildSeconds : 0) << " ticks/s)\n";
+        }
+        const double seconds = std::chrono::duration<double>(wallTime).count();
+        output << "Files: " << reports.size() - failed << " done, " << failed << " failed" << '\n'
+               << "Total ticks: " << ticks << '\n'
+               << "Wall time: " << std::setprecision(1) << seconds * 1e3 << " ms" << '\n'
+               << "Aggregate throughput: " << std::setprecision(0) << (seconds > 0 ? ticks / seconds : 0)
+               << " ticks/s" << std::endl;
+    }
+} // quant
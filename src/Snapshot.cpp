@@ -0,0 +1,216 @@
+/**
+ * @file    Snapshot.cpp
+ * @brief   Source code of checkpoints of full state of both sides of Order Book
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <endian.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "Snapshot.h"
+#include "TickFile.h"
+
+namespace quant {
+    /// @brief Size of header of snapshot file
+    constexpr std::size_t SNAPSHOT_HEADER_SIZE = 40;
+    /// @brief Size of one level and one Order in snapshot file
+    constexpr std::size_t SNAPSHOT_LEVEL_SIZE = 12;
+    constexpr std::size_t SNAPSHOT_ORDER_SIZE = 12;
+
+    /// @brief Prefix and suffix of names of snapshot files, ticks in between
+    static const std::string SNAPSHOT_PREFIX = "snapshot_";
+    static const std::string SNAPSHOT_SUFFIX = ".bin";
+
+    /// @comment Appends little-endian values to buffer
+    static void put16(std::vector<unsigned char>& buffer, uint16_t value) {
+        value = htole16(value);
+        buffer.insert(buffer.end(), reinterpret_cast<unsigned char*>(&value), reinterpret_cast<unsigned char*>(&value) + 2);
+    }
+
+    static void put32(std::vector<unsigned char>& buffer, uint32_t value) {
+        value = htole32(value);
+        buffer.insert(buffer.end(), reinterpret_cast<unsigned char*>(&value), reinterpret_cast<unsigned char*>(&value) + 4);
+    }
+
+    static void put64(std::vector<unsigned char>& buffer, uint64_t value) {
+        value = htole64(value);
+        buffer.insert(buffer.end(), reinterpret_cast<unsigned char*>(&value), reinterpret_cast<unsigned char*>(&value) + 8);
+    }
+
+    /// @class Reads little-endian values from snapshot, throws if snapshot is shorter than expected
+    class SnapshotReader {
+    public:
+        SnapshotReader(const std::string& path, const std::vector<unsigned char>& buffer)
+            : _path(path), _buffer(buffer) {}
+
+        uint16_t get16() { uint16_t value; take(&value, sizeof(value)); return le16toh(value); }
+        uint32_t get32() { uint32_t value; take(&value, sizeof(value)); return le32toh(value); }
+        uint64_t get64() { uint64_t value; take(&value, sizeof(value)); return le64toh(value); }
+
+        /// @brief Checking if there are at least given number of bytes left
+        bool has(std::size_t bytes) const { return _buffer.size() - _position >= bytes; }
+        bool atEnd() const { return _position == _buffer.size(); }
+
+    private:
+        void take(void* value, std::size_t size) {
+            if (!has(size)) throw std::runtime_error(_path + ": snapshot is truncated");
+            std::memcpy(value, _buffer.data() + _position, size);
+            _position += size;
+        }
+
+        const std::string& _path;
+        const std::vector<unsigned char>& _buffer;
+        std::size_t _position = 0;
+    };
+
+    /// @comment Levels from the best one, Orders of level from head of its FIFO queue
+    template<Side side>
+    static void encodeSide(std::vector<unsigned char>& buffer, const OrderBook<side>& orderBook) {
+        for (std::size_t depth = 0; depth < orderBook.noLevels(); ++depth) {
+            const Level& level = orderBook.levelAt(depth);
+            put32(buffer, level.price);
+            put32(buffer, level.shares);
+            put32(buffer, level.orders);
+            for (OrderHandle handle = level.head; handle != NO_HANDLE; handle = orderBook.order(handle).next) {
+                put64(buffer, orderBook.order(handle).id);
+                put32(buffer, orderBook.order(handle).qty);
+            }
+        }
+    }
+
+    /// @comment Orders are added in FIFO order, so queues are the same as before - totals are checked against them
+    template<Side side>
+    static void decodeSide(SnapshotReader& reader, const std::string& path, uint32_t levels, OrderBook<side>& orderBook) {
+        for (uint32_t i = 0; i < levels; ++i) {
+            uint32_t price = reader.get32();
+            uint32_t shares = reader.get32();
+            uint32_t orders = reader.get32();
+            if (orders == 0 || !reader.has(orders * SNAPSHOT_ORDER_SIZE)) {
+                throw std::runtime_error(path + ": snapshot has broken level");
+            }
+            for (uint32_t j = 0; j < orders; ++j) {
+                uint64_t orderID = reader.get64();
+                orderBook.addOrder(orderID, price, reader.get32());
+            }
+            if (orderBook.noShares(price) != shares || orderBook.noOrders(price) != orders) {
+                throw std::runtime_error(path + ": snapshot totals don't match its Orders");
+            }
+        }
+    }
+
+    /// @brief Best level of side in form of result columns - empty Quote if side is empty
+    template<Side side>
+    static Quote bestOf(const OrderBook<side>& orderBook) {
+        if (orderBook.noLevels() == 0) return Quote{};
+        const Level& level = orderBook.levelAt(0);
+        return Quote{level.price, level.shares, level.orders};
+    }
+
+    void saveSnapshot(const std::string& path, const Book& book, const Checkpoint& checkpoint) {
+        std::vector<unsigned char> buffer;
+        put32(buffer, SNAPSHOT_MAGIC);
+        put16(buffer, SNAPSHOT_VERSION);
+        put16(buffer, 0);
+        put64(buffer, checkpoint.ticks);
+        put64(buffer, checkpoint.offset);
+        put64(buffer, checkpoint.sourceTime);
+        put32(buffer, static_cast<uint32_t>(book.bidOrderBook.noLevels()));
+        put32(buffer, static_cast<uint32_t>(book.askOrderBook.noLevels()));
+        encodeSide(buffer, book.bidOrderBook);
+        encodeSide(buffer, book.askOrderBook);
+
+        // Written under temporary name and renamed - crash during writing never leaves broken snapshot
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            if (!file.flush()) throw std::system_error(errno, std::generic_category(), temporary);
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+    }
+
+    Checkpoint loadSnapshot(const std::string& path, Book& book) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::system_error(errno, std::generic_category(), path);
+        const std::vector<unsigned char> buffer{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+        SnapshotReader reader(path, buffer);
+        if (!reader.has(SNAPSHOT_HEADER_SIZE) || reader.get32() != SNAPSHOT_MAGIC) {
+            throw std::runtime_error(path + ": not a snapshot");
+        }
+        if (reader.get16() != SNAPSHOT_VERSION) throw std::runtime_error(path + ": unsupported version of snapshot");
+        reader.get16();
+        Checkpoint checkpoint{};
+        checkpoint.ticks = reader.get64();
+        checkpoint.offset = reader.get64();
+        checkpoint.sourceTime = reader.get64();
+        uint32_t bidLevels = reader.get32();
+        uint32_t askLevels = reader.get32();
+        if (!reader.has((static_cast<std::size_t>(bidLevels) + askLevels) * SNAPSHOT_LEVEL_SIZE)) {
+            throw std::runtime_error(path + ": snapshot is truncated");
+        }
+        if (checkpoint.offset != checkpoint.ticks * RECORD_SIZE) {
+            throw std::runtime_error(path + ": snapshot offset doesn't match number of ticks");
+        }
+
+        book.clearAll();
+        decodeSide(reader, path, bidLevels, book.bidOrderBook);
+        decodeSide(reader, path, askLevels, book.askOrderBook);
+        if (!reader.atEnd()) throw std::runtime_error(path + ": snapshot has unexpected data at the end");
+        // Top written to the last tick before snapshot - the first resumed tick reports its changes against it
+        book.bidTop = bestOf(book.bidOrderBook);
+        book.askTop = bestOf(book.askOrderBook);
+        return checkpoint;
+    }
+
+    /// @comment Number of ticks is zero-padded, so names are sorted in the same order as snapshots
+    std::string snapshotPath(const std::string& directory, uint64_t ticks) {
+        std::string number = std::to_string(ticks);
+        return directory + "/" + SNAPSHOT_PREFIX + std::string(20 - number.size(), '0') + number + SNAPSHOT_SUFFIX;
+    }
+
+    std::optional<std::string> findSnapshot(const std::string& directory, uint64_t maxTicks) {
+        std::error_code error;
+        std::optional<std::string> found;
+        uint64_t foundTicks = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            const std::string name = entry.path().filename().string();
+            if (name.size() != SNAPSHOT_PREFIX.size() + 20 + SNAPSHOT_SUFFIX.size()
+                || name.compare(0, SNAPSHOT_PREFIX.size(), SNAPSHOT_PREFIX) != 0
+                || name.compare(name.size() - SNAPSHOT_SUFFIX.size(), SNAPSHOT_SUFFIX.size(), SNAPSHOT_SUFFIX) != 0) {
+                continue;
+            }
+            const std::string number = name.substr(SNAPSHOT_PREFIX.size(), 20);
+            if (!std::all_of(number.begin(), number.end(), [](unsigned char c) { return std::isdigit(c); })) continue;
+            uint64_t ticks = std::stoull(number);
+            if (ticks <= maxTicks && (!found || ticks > foundTicks)) {
+                found = entry.path().string();
+                foundTicks = ticks;
+            }
+        }
+        return found;
+    }
+
+    Checkpointer::Checkpointer(std::string directory, std::size_t every, bool onClear)
+        : _directory(std::move(directory)), _every(every), _onClear(onClear) {
+        if (_every != 0 || _onClear) std::filesystem::create_directories(_directory);
+    }
+
+    void Checkpointer::write(const Book& book, const Pattern& tick, uint64_t ticks) {
+        saveSnapshot(snapshotPath(_directory, ticks), book, Checkpoint{ticks, ticks * RECORD_SIZE, tick.SourceTime});
+        ++_written;
+    }
+} // quant
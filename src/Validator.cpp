@@ -0,0 +1,291 @@
+/**
+ * @file    Validator.cpp
+ * @brief   Source code of validation of Order Book against ReferenceBook and golden CSV
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "ReferenceBook.h"
+#include "TickFile.h"
+#include "Validator.h"
+
+namespace quant {
+    /// @struct Levels of both sides in comparable form - the best level first, empty Quotes after the last level
+    struct BookLevels {
+        std::array<Quote, MAX_DEPTH> bids;
+        std::array<Quote, MAX_DEPTH> asks;
+        std::size_t bidLevels = 0;
+        std::size_t askLevels = 0;
+    };
+
+    /// @comment Level 0 is taken from result columns of tick - exactly what is written to output
+    static BookLevels levelsOf(const Book& book, const Pattern& tick) {
+        BookLevels levels;
+        levels.bidLevels = book.bidOrderBook.noLevels();
+        levels.askLevels = book.askOrderBook.noLevels();
+        levels.bids[0] = Quote{tick.B0, tick.BQ0, tick.BN0};
+        levels.asks[0] = Quote{tick.A0, tick.AQ0, tick.AN0};
+        for (std::size_t depth = 1; depth < MAX_DEPTH; ++depth) {
+            if (depth < levels.bidLevels) {
+                const Level& level = book.bidOrderBook.levelAt(depth);
+                levels.bids[depth] = Quote{level.price, level.shares, level.orders};
+            }
+            if (depth < levels.askLevels) {
+                const Level& level = book.askOrderBook.levelAt(depth);
+                levels.asks[depth] = Quote{level.price, level.shares, level.orders};
+            }
+        }
+        return levels;
+    }
+
+    /// @comment Ticks with unknown action aren't processed by runActions - their result columns stay empty
+    static BookLevels levelsOf(const ReferenceBook& reference, const Pattern& tick) {
+        BookLevels levels;
+        levels.bidLevels = reference.noLevels(Side::bid);
+        levels.askLevels = reference.noLevels(Side::ask);
+        for (std::size_t depth = 0; depth < MAX_DEPTH; ++depth) {
+            levels.bids[depth] = reference.level(Side::bid, depth);
+            levels.asks[depth] = reference.level(Side::ask, depth);
+        }
+        if (Operation::ignore == OPERATIONS[tick.Action]) levels.bids[0] = levels.asks[0] = Quote{};
+        return levels;
+    }
+
+    static std::string formatQuote(const Quote& quote) {
+        if (quote.Price == UINT32_MAX) return "-";
+        return std::to_string(quote.Price) + '/' + std::to_string(quote.Qty) + '/' + std::to_string(quote.Orders);
+    }
+
+    /**
+     * @brief Description of the first difference between expected and actual levels
+     * @return Empty string if levels are the same
+     */
+    static std::string firstDifference(const BookLevels& expected, const BookLevels& actual) {
+        std::ostringstream difference;
+        if (expected.bidLevels != actual.bidLevels) {
+            difference << "number of bid levels: expected " << expected.bidLevels << ", got " << actual.bidLevels;
+        }
+        else if (expected.askLevels != actual.askLevels) {
+            difference << "number of ask levels: expected " << expected.askLevels << ", got " << actual.askLevels;
+        }
+        else {
+            for (std::size_t depth = 0; depth < MAX_DEPTH && difference.tellp() == 0; ++depth) {
+                if (expected.bids[depth] != actual.bids[depth]) {
+                    difference << "bid level " << depth << ": expected " << formatQuote(expected.bids[depth])
+                               << ", got " << formatQuote(actual.bids[depth]);
+                }
+                else if (expected.asks[depth] != actual.asks[depth]) {
+                    difference << "ask level " << depth << ": expected " << formatQuote(expected.asks[depth])
+                               << ", got " << formatQuote(actual.asks[depth]);
+                }
+            }
+        }
+        return difference.str();
+    }
+
+    static void printLevels(std::ostream& report, const char* name, const BookLevels& levels) {
+        report << "  " << name << " bids (" << levels.bidLevels << " levels):";
+        for (std::size_t depth = 0; depth < MAX_DEPTH && depth < levels.bidLevels; ++depth) {
+            report << ' ' << formatQuote(levels.bids[depth]);
+        }
+        report << '\n' << "  " << name << " asks (" << levels.askLevels << " levels):";
+        for (std::size_t depth = 0; depth < MAX_DEPTH && depth < levels.askLevels; ++depth) {
+            report << ' ' << formatQuote(levels.asks[depth]);
+        }
+        report << '\n';
+    }
+
+    /**
+     * @brief Print the first divergence with context
+     * @param previous The last ticks before diverged one - index and tick with result columns
+     */
+    static void printDivergence(std::ostream& report, std::size_t index, const Pattern& tick,
+                                const std::string& difference, const std::deque<std::pair<std::size_t, Pattern>>& previous,
+                                const BookLevels& expected, const BookLevels& actual) {
+        Pattern diverged = tick;
+        report << "  tick " << index << ": " << printCSV(diverged)
+               << "  " << difference << '\n'
+               << "  previous ticks:\n";
+        for (const auto& [previousIndex, previousTick] : previous) {
+            Pattern copy = previousTick;
+            report << "    " << previousIndex << ": " << printCSV(copy);
+        }
+        printLevels(report, "ReferenceBook", expected);
+        printLevels(report, "Order Book   ", actual);
+    }
+
+    bool validateReplay(const std::string& inputFile, const BookCapacity& capacity, std::ostream& report) {
+        TickFile file(inputFile);
+        Book book(capacity);
+        ReferenceBook reference;
+        std::deque<std::pair<std::size_t, Pattern>> previous;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t index = 0; index < file.size(); ++index) {
+            Pattern tick = *file.at(index);
+            runActions(book, tick);
+            reference.apply(tick);
+            const BookLevels expected = levelsOf(reference, tick);
+            const BookLevels actual = levelsOf(book, tick);
+            const std::string difference = firstDifference(expected, actual);
+            if (!difference.empty()) {
+                report << "Replay: Order Book diverged from ReferenceBook at tick " << index << " (record offset "
+                       << index * RECORD_SIZE << ")\n";
+                printDivergence(report, index, tick, difference, previous, expected, actual);
+                return false;
+            }
+            previous.emplace_back(index, tick);
+            if (previous.size() > DIVERGENCE_CONTEXT) previous.pop_front();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report << "Replay: " << file.size() << " ticks, Order Book agrees with ReferenceBook (" << std::fixed
+               << std::setprecision(1) << seconds * 1e3 << " ms)" << std::endl;
+        return true;
+    }
+
+    /// @comment Lines are compared as text, fields are split only to name different columns
+    static std::vector<std::string> splitFields(const std::string& line) {
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        for (std::string field; std::getline(stream, field, ';');) fields.push_back(field);
+        if (!line.empty() && line.back() == ';') fields.emplace_back();
+        return fields;
+    }
+
+    static bool readLine(std::istream& input, std::string& line) {
+        if (!std::getline(input, line)) return false;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        return true;
+    }
+
+    bool validateGolden(const std::string& outputFile, const std::string& goldenFile, std::ostream& report) {
+        std::ifstream output(outputFile);
+        std::ifstream golden(goldenFile);
+        if (!output || !golden) {
+            report << "Golden: can't open " << (!output ? outputFile : goldenFile) << std::endl;
+            return false;
+        }
+        std::deque<std::string> previous;
+        std::vector<std::string> columns;
+        std::string expected, actual;
+        std::size_t line = 0;
+        while (readLine(golden, expected)) {
+            ++line;
+            if (columns.empty()) columns = splitFields(expected);
+            if (!readLine(output, actual)) {
+                report << "Golden: " << outputFile << " ends at line " << line << ", " << goldenFile
+                       << " continues with:\n  " << expected << std::endl;
+                return false;
+            }
+            if (expected != actual) {
+                report << "Golden: line " << line << " differs from " << goldenFile << '\n'
+                       << "  expected: " << expected << '\n'
+                       << "  got:      " << actual << '\n';
+                const std::vector<std::string> expectedFields = splitFields(expected);
+                const std::vector<std::string> actualFields = splitFields(actual);
+                for (std::size_t i = 0; i < std::max(expectedFields.size(), actualFields.size()); ++i) {
+                    const std::string want = i < expectedFields.size() ? expectedFields[i] : "<none>";
+                    const std::string got = i < actualFields.size() ? actualFields[i] : "<none>";
+                    if (want == got) continue;
+                    report << "  column " << (i < columns.size() ? columns[i] : std::to_string(i)) << ": expected '"
+                           << want << "', got '" << got << "'\n";
+                }
+                report << "  previous lines:\n";
+                for (const std::string& text : previous) report << "    " << text << '\n';
+                report.flush();
+                return false;
+            }
+            previous.push_back(actual);
+            if (previous.size() > DIVERGENCE_CONTEXT) previous.pop_front();
+        }
+        report << "Golden: " << line << " lines of " << goldenFile << " match" << std::endl;
+        return true;
+    }
+
+    /// @comment IDs from FUZZ_DIRECT_BASE on are kept in direct range of index, the rest is hashed. Prices fit
+    ///          in MAX_DEPTH levels, so every level of both sides is compared after each action
+    bool fuzzBooks(std::size_t actions, uint64_t seed, std::ostream& report) {
+        constexpr uint64_t FUZZ_DIRECT_BASE = 20220620000000;
+        constexpr std::size_t FUZZ_DIRECT_SIZE = 512;
+        constexpr uint32_t FUZZ_IDS = 1024;
+        constexpr uint32_t FUZZ_PRICES = MAX_DEPTH;
+        constexpr uint32_t FUZZ_BASE_PRICE = 1650;
+
+        std::mt19937_64 random(seed);
+        auto pick = [&](uint32_t count) { return static_cast<uint32_t>(random() % count); };
+        Book book;
+        book.bidOrderBook.directIds(FUZZ_DIRECT_BASE, FUZZ_DIRECT_SIZE);
+        book.askOrderBook.directIds(FUZZ_DIRECT_BASE, FUZZ_DIRECT_SIZE);
+        ReferenceBook reference;
+        std::deque<std::pair<std::size_t, Pattern>> previous;
+
+        for (std::size_t step = 0; step < actions; ++step) {
+            Pattern tick{};
+            tick.SourceTime = step;
+            const uint32_t roll = pick(1000);
+            const Action action = roll < 420 ? Action::add : roll < 720 ? Action::modify
+                                  : roll < 980 ? Action::remove : roll & 1 ? Action::clear1 : Action::clear2;
+            // Some ticks get unknown action or side - they have to be ignored the same way by both books
+            tick.Action = roll < 985 ? static_cast<uint8_t>(action) : 'X';
+            tick.Side = pick(100) < 2 ? '0' : static_cast<uint8_t>(pick(2) ? Side::bid : Side::ask);
+            tick.OrderId = FUZZ_DIRECT_BASE - FUZZ_IDS / 2 + pick(FUZZ_IDS);
+            tick.Price = FUZZ_BASE_PRICE + pick(FUZZ_PRICES);
+            tick.Qty = pick(10) == 0 ? 0 : 1 + pick(200);
+
+            runActions(book, tick);
+            reference.apply(tick);
+            const BookLevels expected = levelsOf(reference, tick);
+            const BookLevels actual = levelsOf(book, tick);
+            const std::string difference = firstDifference(expected, actual);
+            if (!difference.empty()) {
+                report << "Fuzz: Order Book diverged from ReferenceBook at action " << step << " (seed " << seed
+                       << ")\n";
+                printDivergence(report, step, tick, difference, previous, expected, actual);
+                return false;
+            }
+            previous.emplace_back(step, tick);
+            if (previous.size() > DIVERGENCE_CONTEXT) previous.pop_front();
+        }
+        report << "Fuzz: " << actions << " random actions (seed " << seed << "), Order Book agrees with ReferenceBook"
+               << std::endl;
+        return true;
+    }
+
+    /// @comment Golden file has only best levels, so output for it is always CSV of depth 1 with all ticks. It is
+    ///          written to temporary file without snapshots, so results and checkpoints of real runs stay untouched
+    bool validate(const ReaderOptions& options, const std::string& goldenFile, std::size_t fuzzActions,
+                  uint64_t seed) {
+        bool passed = MsgReader::checkPriceMoves();
+        passed = validateReplay(options.inputFile, options.capacity, std::cout) && passed;
+
+        ReaderOptions outputOptions = options;
+        outputOptions.format = OutputFormat::csv;
+        outputOptions.depth = 1;
+        outputOptions.filter = OutputFilter::all;
+        outputOptions.resume = false;
+        outputOptions.checkpointEvery = 0;
+        outputOptions.checkpointOnClear = false;
+        outputOptions.quiet = true;
+        outputOptions.outputFile = (std::filesystem::temp_directory_path()
+                                    / ("order_book_validate_" + std::to_string(::getpid()) + ".csv")).string();
+        MsgReader::read(outputOptions);
+        passed = validateGolden(outputOptions.outputFile, goldenFile, std::cout) && passed;
+        std::filesystem::remove(outputOptions.outputFile);
+
+        if (fuzzActions > 0) passed = fuzzBooks(fuzzActions, seed, std::cout) && passed;
+        std::cout << (passed ? "Validation passed" : "Validation FAILED") << std::endl;
+        return passed;
+    }
+} // quant
@@ -0,0 +1,42 @@
+/**
+ * @file    bin2csv.cpp
+ * @brief   Converter of binary result file to the same CSV as written by application
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <array>
+#include <exception>
+#include <iostream>
+
+#include "BinaryFormat.h"
+#include "CsvWriter.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.bin> <output.csv>" << std::endl;
+        return 2;
+    }
+
+    try {
+        quant::BinaryFile input(argv[1]);
+        quant::CsvWriter output(argv[2]);
+        std::size_t depth = input.depth();
+        output.writeHeader(depth);
+        std::array<quant::Quote, 2 * (quant::MAX_DEPTH - 1)> levels;
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            quant::Pattern tick;
+            quant::decodeRecord(input[i], tick);
+            for (std::size_t level = 0; level + 2 < 2 * depth; ++level) {
+                quant::decodeQuote(input.quotes(i)[level], levels[level]);
+            }
+            output.write(tick, levels.data(), depth);
+        }
+        output.flush();
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
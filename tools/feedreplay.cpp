@@ -0,0 +1,76 @@
+/**
+ * @file    feedreplay.cpp
+ * @brief   Replay of binary input file into live feed - at pacing of recorded SourceTime or at max rate
+ * @author  Marcin Piwowar
+ * @mail    m.piwowar2@gmail.com
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "LiveFeed.h"
+#include "TickFile.h"
+
+/// @brief Records sent at once - about one read of FeedSource
+constexpr std::size_t RECORDS_PER_SEND = quant::FeedSource::READ_SIZE / quant::RECORD_SIZE;
+
+/// @comment Report goes to stderr, because stdout can be the feed itself
+int main(int argc, char* argv[]) {
+    std::string address;
+    std::string inputFile = INPUT_FILE;
+    double speed = 1.0;
+    bool maxRate = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-rate") == 0) maxRate = true;
+        else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc) speed = std::strtod(argv[++i], nullptr);
+        else if (address.empty()) address = argv[i];
+        else inputFile = argv[i];
+    }
+    if (address.empty() || speed <= 0.0) {
+        std::cerr << "Usage: " << argv[0] << " <unix:PATH | udp:ADDRESS:PORT | fifo:PATH | -> [input.raw]"
+                  << " [--speed X | --max-rate]" << std::endl;
+        return 2;
+    }
+
+    try {
+        quant::TickFile file(inputFile);
+        quant::FeedSink sink(quant::parseFeed(address));
+        auto start = std::chrono::steady_clock::now();
+        const uint64_t firstTime = file.size() > 0 ? (*file.begin()).SourceTime : 0;
+        // Moment when record should be sent - SourceTime is in microseconds
+        auto dueOf = [&](std::size_t index) {
+            const auto offset = static_cast<double>((*file.at(index)).SourceTime - firstTime) / speed;
+            return start + std::chrono::microseconds(static_cast<int64_t>(offset));
+        };
+
+        for (std::size_t first = 0; first < file.size();) {
+            std::size_t last = std::min(first + RECORDS_PER_SEND, file.size());
+            if (!maxRate) {
+                std::this_thread::sleep_until(dueOf(first));
+                // Records which are already due go together, the rest waits for its time
+                const auto now = std::chrono::steady_clock::now();
+                std::size_t due = first + 1;
+                while (due < last && dueOf(due) <= now) ++due;
+                last = due;
+            }
+            sink.send(file.at(first).data(), last - first);
+            first = last;
+        }
+        sink.close();
+
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cerr << "Sent " << file.size() << " records to " << address << " in " << time.count() << " ms"
+                  << std::endl;
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}